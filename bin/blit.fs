@@ -0,0 +1,12 @@
+#version 330 core
+in vec2 TexCoord;
+
+out vec4 fragColor;
+
+// premultiplied alpha, blend with GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+uniform sampler2D textureUnit;
+
+void main()
+{
+    fragColor = texture(textureUnit, TexCoord);
+}
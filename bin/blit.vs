@@ -0,0 +1,12 @@
+#version 330 core
+
+// full screen quad from the vertex id, drawn as a 4 vertex triangle strip
+out vec2 TexCoord;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+    TexCoord    = corner;
+}
@@ -1,12 +1,21 @@
 #version 330 core
 in vec2 TexCoords;
+in vec3 TextColor;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColor;
+uniform bool sdf; // atlas holds distance fields, 0.5 is the glyph edge
 
 void main()
 {    
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = vec4(textColor, 1.0) * sampled;
+    float alpha = texture(text, TexCoords).r;
+
+    if (sdf)
+    {
+        // about one screen pixel of smoothing at any scale
+        float width = fwidth(alpha);
+        alpha = smoothstep(0.5 - width, 0.5 + width, alpha);
+    }
+
+    color = vec4(TextColor, alpha);
 }
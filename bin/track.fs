@@ -0,0 +1,12 @@
+#version 330 core
+in vec4 TrackColor;
+
+out vec4 fragColor;
+
+void main()
+{
+    if (TrackColor.a <= 0.0)
+        discard;
+
+    fragColor = TrackColor;
+}
@@ -0,0 +1,21 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;      // unit box corner
+layout (location = 1) in vec4 aInstance; // <vec2 position, size, time laid>
+layout (location = 2) in vec4 aColor;
+
+uniform mat4  MVP;
+uniform float time;
+uniform float lifespan;
+
+out vec4 TrackColor;
+
+void main()
+{
+    // track markers have no time stamp and never fade, crumbs fade out over their lifespan
+    float alpha = 1.0;
+    if (aInstance.w >= 0.0)
+        alpha = clamp(1.0 - (time - aInstance.w) / lifespan, 0.0, 1.0);
+
+    gl_Position = MVP * vec4(aInstance.xy + aPos * aInstance.z, 0.0, 1.0);
+    TrackColor  = vec4(aColor.rgb, aColor.a * alpha);
+}
@@ -1,5 +1,6 @@
 
 #include "CImage.h"
+#include "GlState.h"
 
 CShader *CImage::mShader = nullptr;
 
@@ -34,9 +35,9 @@ CImage::CImage(std::string imFname, unsigned int mUnit) : mFileName(imFname),
 
 CImage::~CImage()
 {
-   GLCALL(glDeleteVertexArrays(1, &VAO));
-   GLCALL(glDeleteBuffers(1, &VBO));
-   GLCALL(glDeleteBuffers(1, &EBO));
+   CGlState::DeleteVertexArray(VAO);
+   CGlState::DeleteBuffer(VBO);
+   CGlState::DeleteBuffer(EBO);
 
    std::cout << "CIMAGE DEleting VAO, VBO, and EBO " << std::endl;
 }
@@ -61,7 +62,7 @@ void CImage::LoadImage(void)
    unsigned int dataFormat = 0;
 
    GLCALL(glGenTextures(1, &mTexture));
-   GLCALL(glBindTexture(GL_TEXTURE_2D, mTexture));
+   CGlState::BindTexture(GL_TEXTURE_2D, mTexture);
    // set the texture wrapping parameters
    GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT)); // set texture wrapping to GL_REPEAT (default wrapping method)
    GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
@@ -115,19 +116,19 @@ void CImage::CreateVAO(void)
 {
    if (VAO != 0)
    {
-      GLCALL(glDeleteVertexArrays(1, &VAO));
-      GLCALL(glDeleteBuffers(1, &VBO));
-      GLCALL(glDeleteBuffers(1, &EBO));
+      CGlState::DeleteVertexArray(VAO);
+      CGlState::DeleteBuffer(VBO);
+      CGlState::DeleteBuffer(EBO);
    }
 
    GLCALL(glGenVertexArrays(1, &VAO));
    GLCALL(glGenBuffers(1, &VBO));
    GLCALL(glGenBuffers(1, &EBO));
 
-   GLCALL(glBindVertexArray(VAO));
-   GLCALL(glBindBuffer(GL_ARRAY_BUFFER, VBO));
+   CGlState::BindVertexArray(VAO);
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, VBO);
    GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(mVertices), mVertices, GL_DYNAMIC_DRAW));
-   GLCALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO));
+   CGlState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
    GLCALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(mIndices), mIndices, GL_DYNAMIC_DRAW));
 
    // position attribute
@@ -154,10 +155,10 @@ void CImage::DrawImage(void)
       mShader->setInt("textureUnit", mGlTexUnit-GL_TEXTURE0);
       mShader->setFloat("Alpha", mAlpha);
 
-      GLCALL(glActiveTexture(mGlTexUnit));
-      GLCALL(glBindTexture(GL_TEXTURE_2D, mTexture));
+      CGlState::ActiveTexture(mGlTexUnit);
+      CGlState::BindTexture(GL_TEXTURE_2D, mTexture);
 
-      GLCALL(glBindVertexArray(VAO));
+      CGlState::BindVertexArray(VAO);
       GLCALL(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0));
 
       // reset model matrix
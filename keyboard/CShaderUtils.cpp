@@ -4,7 +4,9 @@
  * Contributors: Sylvain Beucler
  */
 
+#include <string.h>
 #include "CShaderUtils.h"
+#include "GlState.h"
 
 CShader::CShader(const char *vertexPath, const char *fragmentPath, const char *geometryPath)
 {
@@ -80,6 +82,7 @@ CShader::CShader(const char *vertexPath, const char *fragmentPath, const char *g
       GLCALL(glAttachShader(mID, geometry));
    GLCALL(glLinkProgram(mID));
    checkCompileErrors(mID, "PROGRAM");
+   LoadUniforms();
    // delete the shaders as they're linked into our program now and no longer necessary
 
    GLCALL(glDeleteShader(vertex));
@@ -98,6 +101,11 @@ CShader::~CShader()
    GLCALL(glDeleteProgram(mID));
 }
 
+void CShader::use()
+{
+   CGlState::UseProgram(mID);
+}
+
 GLint CShader::GetAttrib(GLuint program, const char *name)
 {
    GLint attribute;
@@ -115,6 +123,61 @@ GLint CShader::GetUniform(GLuint program, const char *name)
       fprintf(stderr, "Could not bind uniform %s\n", name);
    return uniform;
 }
+// look up every active uniform once after linking so the set functions
+// never have to ask the driver for a location by name
+// ------------------------------------------------------------------------
+void CShader::LoadUniforms()
+{
+   GLint count = 0;
+   GLchar name[256];
+
+   mUniforms.clear();
+
+   GLCALL(glGetProgramiv(mID, GL_ACTIVE_UNIFORMS, &count));
+
+   for (GLint i = 0; i < count; i++)
+   {
+      GLsizei length = 0;
+      GLint size = 0;
+      GLenum type = 0;
+      Uniform uniform = {};
+
+      GLCALL(glGetActiveUniform(mID, (GLuint)i, sizeof(name), &length, &size, &type, name));
+
+      std::string key(name, length);
+
+      // arrays are reported as "name[0]", look them up by the plain name
+      if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0)
+         key.resize(key.size() - 3);
+
+      GLCALL(uniform.Location = glGetUniformLocation(mID, name));
+      uniform.Size = 0; // nothing set yet
+
+      mUniforms[key] = uniform;
+   }
+}
+
+// returns the location to set, or -1 if the uniform isn't active in this
+// program or already holds the value
+// ------------------------------------------------------------------------
+GLint CShader::Update(const std::string &name, const void *value, size_t size) const
+{
+   auto it = mUniforms.find(name);
+
+   if (it == mUniforms.end() || size > sizeof(it->second.Value))
+      return -1;
+
+   Uniform &uniform = it->second;
+
+   if (uniform.Size == size && memcmp(uniform.Value, value, size) == 0)
+      return -1;
+
+   memcpy(uniform.Value, value, size);
+   uniform.Size = size;
+
+   return uniform.Location;
+}
+
 // utility function for checking shader compilation/linking errors.
 // ------------------------------------------------------------------------
 void CShader::checkCompileErrors(GLuint shader, std::string type)
@@ -14,6 +14,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <string>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -42,7 +43,20 @@
 
 class CShader
 {
+   // active uniform resolved at link time, with a shadow copy of the last value
+   // set so unchanged uniforms don't go back to the driver
+   struct Uniform
+   {
+      GLint    Location;
+      size_t   Size;
+      unsigned char Value[sizeof(glm::mat4)];
+   };
+
+   mutable std::unordered_map<std::string, Uniform> mUniforms;
+
    void checkCompileErrors(GLuint shader, std::string type);
+   void LoadUniforms();
+   GLint Update(const std::string &name, const void *value, size_t size) const;
 
 public:
    unsigned int mID;
@@ -61,91 +75,80 @@ public:
    GLint GetUniform(GLuint program, const char *name);
    // activate the shader
    // ------------------------------------------------------------------------
-   void use()
-   {
-      GLCALL(glUseProgram(mID));
-   }
-   // utility uniform functions
+   void use();
+   // utility uniform functions, the program must be in use
    // ------------------------------------------------------------------------
    void setBool(const std::string &name, bool value) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform1i(location, (int)value));
+      setInt(name, (int)value);
    }
    // ------------------------------------------------------------------------
    void setInt(const std::string &name, int value) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform1i(location, value));
+      GLint location = Update(name, &value, sizeof(value));
+      if (location != -1)
+         GLCALL(glUniform1i(location, value));
    }
    // ------------------------------------------------------------------------
    void setFloat(const std::string &name, float value) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform1f(location, value));
+      GLint location = Update(name, &value, sizeof(value));
+      if (location != -1)
+         GLCALL(glUniform1f(location, value));
    }
    // ------------------------------------------------------------------------
    void setVec2(const std::string &name, const glm::vec2 &value) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform2fv(location, 1, &value[0]));
+      GLint location = Update(name, &value[0], sizeof(value));
+      if (location != -1)
+         GLCALL(glUniform2fv(location, 1, &value[0]));
    }
    void setVec2(const std::string &name, float x, float y) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform2f(location, x, y));
+      setVec2(name, glm::vec2(x, y));
    }
    // ------------------------------------------------------------------------
    void setVec3(const std::string &name, const glm::vec3 &value) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform3fv(location, 1, &value[0]));
+      GLint location = Update(name, &value[0], sizeof(value));
+      if (location != -1)
+         GLCALL(glUniform3fv(location, 1, &value[0]));
    }
    void setVec3(const std::string &name, float x, float y, float z) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform3f(location, x, y, z));
+      setVec3(name, glm::vec3(x, y, z));
    }
    // ------------------------------------------------------------------------
    void setVec4(const std::string &name, const glm::vec4 &value) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform4fv(location, 1, &value[0]));
+      GLint location = Update(name, &value[0], sizeof(value));
+      if (location != -1)
+         GLCALL(glUniform4fv(location, 1, &value[0]));
    }
    void setVec4(const std::string &name, float x, float y, float z, float w)
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniform4f(location, x, y, z, w));
+      setVec4(name, glm::vec4(x, y, z, w));
    }
    // ------------------------------------------------------------------------
    void setMat2(const std::string &name, const glm::mat2 &mat) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]));
+      GLint location = Update(name, &mat[0][0], sizeof(mat));
+      if (location != -1)
+         GLCALL(glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]));
    }
    // ------------------------------------------------------------------------
    void setMat3(const std::string &name, const glm::mat3 &mat) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]));
+      GLint location = Update(name, &mat[0][0], sizeof(mat));
+      if (location != -1)
+         GLCALL(glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]));
    }
    // ------------------------------------------------------------------------
    void setMat4(const std::string &name, const glm::mat4 &mat) const
    {
-      GLint location;
-      GLCALL(location = glGetUniformLocation(mID, name.c_str()));
-      GLCALL(glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]));
+      GLint location = Update(name, &mat[0][0], sizeof(mat));
+      if (location != -1)
+         GLCALL(glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]));
    }
 };
 #endif
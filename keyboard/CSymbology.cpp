@@ -44,6 +44,7 @@
 #include <algorithm>
 #include <sstream>
 #include "CSymbology.h"
+#include "GlState.h"
 
 // Unlike Aechelon DLL, we are setting the drawing coordinate system
 // to provide an match the display resolution.  This should allow exact
@@ -61,8 +62,19 @@ const float CSymbology::HOST_COORD_Y_MAX = 1080.0f;
 CSymbology::CSymbology(glm::mat4 &projection, glm::vec3 &windowSize,
                        unsigned int size, const std::string &imgFile) : mFontSize(size),
                                                                   mText(projection, size),
-                                                                  mLine(vec3(windowSize.x, windowSize.y, 0.0f))
+                                                                  mLine(vec3(windowSize.x, windowSize.y, 0.0f)),
+                                                                  mCompassTicks(vec3(windowSize.x, windowSize.y, 0.0f)),
+                                                                  mCompassText(projection, 28),
+                                                                  mSymbols(windowSize),
+                                                                  mTracks(glm::ortho(0.0f, windowSize.x, 0.0f, windowSize.y))
 {
+   mTrackClock.Start();
+
+   // fonts for the text the draw functions create on the fly
+   mFont20 = CText::GetFont(DEFAULT_FONT, 20);
+   mFont28 = CText::GetFont(DEFAULT_FONT, 28);
+   mFont38 = CText::GetFont(DEFAULT_FONT, 38);
+
    mLeftCoordLimit = -1.0;
    mRightCoordLimit = 1.0;
    mTopCoordLimit = 1.0;
@@ -83,18 +95,35 @@ CSymbology::CSymbology(glm::mat4 &projection, glm::vec3 &windowSize,
    mMaxNeg_y = 0.0f;
 
    mPositionInit = false;
-   FromHostUH = new T_FromHostToSymbologyUH;
-   FromHostAH = new T_FromHostToSymbologyAH;
+   FromHostUH = &mHostUH.Read();
+   FromHostAH = &mHostAH.Read();
 
    int arr[2][5] = {{1, 8, 12, 20, 25}, {5, 9, 13, 24, 26}};
 }
 
 CSymbology::~CSymbology()
 {
-   if (FromHostUH)
-      delete FromHostUH;
-   if (FromHostAH)
-      delete FromHostAH;
+}
+
+void CSymbology::Resize(glm::mat4 &projection, glm::vec3 &windowSize)
+{
+   mWidth = windowSize.x;
+   mHeight = windowSize.y;
+   mProjection = projection;
+   mInfoBoxMaxWidth = mWidth / 3;
+   mInfoBoxMaxHeight = mHeight / 3;
+   mMaxPos_x = mWidth;
+   mMaxPos_y = mHeight;
+
+   mText.SetMVP(projection);
+   mCompassText.SetMVP(projection);
+   mLine.SetWindowSize(vec3(windowSize.x, windowSize.y, 0.0f));
+   mCompassTicks.SetWindowSize(vec3(windowSize.x, windowSize.y, 0.0f));
+   mSymbols.SetWindowSize(windowSize);
+   mTracks.SetProjection(glm::ortho(0.0f, windowSize.x, 0.0f, windowSize.y));
+
+   // the compass strip is laid out for the window width
+   mCompassBuilt = false;
 }
 
 void CSymbology::DrawLine(vec3 &start, vec3 &end, bool compat)
@@ -122,11 +151,11 @@ void CSymbology::DrawScaleBarReticle(void)
    float len;
    float offy;
    // default
-   GLCALL(glLineWidth(2.5));
+   CGlState::LineWidth(2.5f);
    vec3 start;
    vec3 end;
 
-   CText stat(mProjection, 38);
+   CText stat(mProjection, mFont38);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    float fixTab = 40;
@@ -173,7 +202,7 @@ void CSymbology::DrawPrimaryLockedTargetReticle(void)
    float off, len;
    float offy;
    // default
-   GLCALL(glLineWidth(2.5));
+   CGlState::LineWidth(2.5f);
    vec3 start;
    vec3 end;
 
@@ -248,7 +277,7 @@ void CSymbology::DrawPotentialTargetRecticule(void)
    float x1, x2, y1, y2, angle, radius;
    vec3 start;
    vec3 end;
-   GLCALL(glLineWidth(15));
+   CGlState::LineWidth(15.0f);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    x_off = (0.0f);
@@ -274,7 +303,7 @@ void CSymbology::DrawPotentialTargetRecticule(void)
    end = vec3(x_off - off - len, y_off, 0.0);
    DrawLine(start, end);
 
-   GLCALL(glLineWidth(2.5));
+   CGlState::LineWidth(2.5f);
 }
 
 float CSymbology::GetTextWidth(std::string &msg)
@@ -298,8 +327,8 @@ void CSymbology::PrintText(std::string &_string)
 void CSymbology::DrawStatusMsg(void)
 {
    // default
-   GLCALL(glLineWidth(2.5));
-   CText stat(mProjection, 38);
+   CGlState::LineWidth(2.5f);
+   CText stat(mProjection, mFont38);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    std::string msg1("TSS FLIR CALIBRATION IN PROGRESS");
@@ -328,183 +357,76 @@ void CSymbology::DrawStatusMsg(void)
 
 void CSymbology::DrawLaserIlluminatorReticle(void)
 {
-   vec3 start;
-   vec3 end;
-   float off, len;
-
    float x_off = (0.5f - FromHostAH->los_x_pos) * 960.0f;
    float y_off = (0.5f - FromHostAH->los_y_pos) * 540.0f;
-   off = 26;
-   len = 82;
-
-   // 12 O'Clock Horizontal Line
-   start = vec3(x_off - off - len, y_off + off + len, 0.0f);
-   end = vec3(x_off + off + len, y_off + off + len, 0.0f);
-   DrawLine(start, end);
 
-   // 6 O'Clock Horiz Line
-   start = vec3(x_off - off - len, y_off - off - len, 0.0f);
-   end = vec3(x_off + off + len, y_off - off - len, 0.0f);
-   DrawLine(start, end);
-
-   // 3 O'Clock Vert Line
-   start = vec3(x_off + off + len, y_off + off + len, 0.0f);
-   end = vec3(x_off + off + len, y_off - off - len, 0.0f);
-   DrawLine(start, end);
-
-   // 9 O'Clock vert Line
-   start = vec3(x_off - off - len, y_off + off + len, 0.0f);
-   end = vec3(x_off - off - len, y_off - off - len, 0.0f);
-   DrawLine(start, end);
+   mSymbols.Draw(SYMBOL_LASER_ILLUMINATOR, x_off, y_off);
 }
 
 void CSymbology::DrawPointStyleLOSReticle(void)
 {
-   vec3 start;
-   vec3 end;
-   float len;
-
-   float x_off = 960.0f;
-   float y_off = 540.0f;
-   len = 10;
-
-   GLCALL(glLineWidth(2.5));
-   vec3 green(0.0f, 1.0f, 0.0f);
+   CGlState::LineWidth(2.5f);
 
    mCompatibility = true;
    mLine.SetCompatibility(mCompatibility);
 
-   mLine.SetLineMode(TRIANGLE);
-
-   len = 10;
-   start = vec3(x_off - len / 2, y_off - len / 2, 0.0f);
-   mLine.Here(start);
-
-   end = vec3(x_off + len / 2, y_off - len / 2, 0.0f);
-   mLine.Here(end);
-
-   start = vec3(x_off + len / 2, y_off + len / 2, 0.0f);
-   mLine.Here(start);
-   mLine.Draw();
-
-   start = vec3(x_off + len / 2, y_off + len / 2, 0.0f);
-   mLine.Here(start);
-
-   start = vec3(x_off - len / 2, y_off + len / 2, 0.0f);
-   mLine.Here(start);
-
-   start = vec3(x_off - len / 2, y_off - len / 2, 0.0f);
-   mLine.Here(start);
-   mLine.Draw();
-
-   mLine.SetLineMode(SOLID);
+   mSymbols.Draw(SYMBOL_POINT_LOS, 960.0f, 540.0f);
 }
 
 void CSymbology::DrawLaserDesignatorReticle(void)
 {
-
-   vec3 start;
-   vec3 end;
-   float off, len;
-
-   float x_off = 40;
-   float y_off = 0;
-   float y_off2 = 40;
-   off = 26;
-   len = 82;
-   float gap = 40;
-
-   // 12 O'Clock Horizontal Line
-   start = vec3(x_off - off - len + gap, y_off + off + len, 0.0f);
-   end = vec3(x_off + off + len - gap, y_off + off + len, 0.0f);
-   DrawLine(start, end);
-
-   // 6 O'Clock Horiz Line
-   start = vec3(x_off - off - len + gap, y_off - off - len, 0.0f);
-   end = vec3(x_off + off + len - gap, y_off - off - len, 0.0f);
-   DrawLine(start, end);
-
-   // 3 O'Clock Vert Line
-   start = vec3(x_off + off + len, y_off + off + len - gap, 0.0f);
-   end = vec3(x_off + off + len, y_off - off - len + gap, 0.0f);
-   DrawLine(start, end);
-
-   // 9 O'Clock vert Line
-   start = vec3(x_off - off - len, y_off + off + len - gap, 0.0f);
-   end = vec3(x_off - off - len, y_off - off - len + gap, 0.0f);
-   DrawLine(start, end);
+   mSymbols.Draw(SYMBOL_LASER_DESIGNATOR, 40.0f, 0.0f);
 }
 
 void CSymbology::DrawAquisitionGateReticle(void)
 {
-
-   vec3 start;
-   vec3 end;
-   float off, len;
-
    float x_off = (0.5f - FromHostAH->los_x_pos) * 960.0f;
    float y_off = (0.5f - FromHostAH->los_y_pos) * 540.0f;
-   off = 26;
-   len = 82;
-
-   mLine.SetLineMode(DASH);
-   mLine.SetDashSize(10.0f);
-   mLine.SetGapSize(10.0f);
-
-   // 12 O'Clock Horizontal Line
-   start = vec3(x_off - off - len, y_off + off + len, 0.0f);
-   end = vec3(x_off + off + len, y_off + off + len, 0.0f);
-   DrawLine(start, end);
-
-   // 6 O'Clock Horiz Line
-   start = vec3(x_off - off - len, y_off - off - len, 0.0f);
-   end = vec3(x_off + off + len, y_off - off - len, 0.0f);
-   DrawLine(start, end);
 
-   // 3 O'Clock Vert Line
-   start = vec3(x_off + off + len, y_off + off + len, 0.0f);
-   end = vec3(x_off + off + len, y_off - off - len, 0.0f);
-   DrawLine(start, end);
+   mSymbols.Draw(SYMBOL_ACQUISITION_GATE, x_off, y_off);
+}
 
-   // 9 O'Clock vert Line
-   start = vec3(x_off - off - len, y_off + off + len, 0.0f);
-   end = vec3(x_off - off - len, y_off - off - len, 0.0f);
-   DrawLine(start, end);
+void CSymbology::DrawStandardLOSReticle(void)
+{
+   float x_off = (0.5f - FromHostAH->los_x_pos) * 960.0f;
+   float y_off = (0.5f - FromHostAH->los_y_pos) * 540.0f;
 
-   mLine.SetLineMode(SOLID);
+   mSymbols.Draw(SYMBOL_STANDARD_LOS, x_off, y_off);
 }
 
-void CSymbology::DrawStandardLOSReticle(void)
+void CSymbology::DrawTrackSymbols(void)
 {
-   float off, len;
+   double now = mTrackClock.GetTime();
 
-   vec3 start;
-   vec3 end;
+   for (int i = 0; i < (int)ArrayCount(FromHostAH->track_symbol); i++)
+   {
+      if (FromHostAH->track_symbol[i])
+      {
+         // same centered offsets as the LOS reticle, moved to window pixels
+         float x = mWidth / 2 + (0.5f - FromHostAH->track_x_pos[i]) * 960.0f;
+         float y = mHeight / 2 + (0.5f - FromHostAH->track_y_pos[i]) * 540.0f;
 
-   float x_off = (0.5f - FromHostAH->los_x_pos) * 960.0f;
-   float y_off = (0.5f - FromHostAH->los_y_pos) * 540.0f;
-   off = 26;
-   len = 52;
+         mTracks.UpdateTrack(i, x, y, mTrackColor, now);
+      }
+      else
+      {
+         mTracks.RemoveTrack(i);
+      }
+   }
 
-   // 12 O'Clock Vert Line
-   start = vec3(x_off, y_off + off, 0.0f);
-   end = vec3(x_off, y_off + off + len, 0.0f);
-   DrawLine(start, end);
+   mTracks.Draw(now);
+}
 
-   // 6 O'Clock Vert Line
-   start = vec3(x_off, y_off + -off, 0.0f);
-   end = vec3(x_off, y_off + -off - len, 0.0f);
-   DrawLine(start, end);
+void CSymbology::SetTrackSettings(eMtiBoxColor BoxColor, bool Breadcrumbs, int MaxBreadcrumbs, float Lifespan)
+{
+   mTrackColor = BoxColor;
+   mTracks.SetBreadcrumbsEnabled(Breadcrumbs);
 
-   // 3 O'Clock Vert Line
-   start = vec3(x_off + off, y_off, 0.0f);
-   end = vec3(x_off + off + len, y_off, 0.0f);
-   DrawLine(start, end);
+   // SetMaxBreadcrumbs() already ignores a negative count
+   mTracks.SetMaxBreadcrumbs(MaxBreadcrumbs);
 
-   // 9 O'Clock Vert Line
-   start = vec3(x_off - off, y_off, 0.0f);
-   end = vec3(x_off - off - len, y_off, 0.0f);
-   DrawLine(start, end);
+   if (Lifespan >= 0.0f)
+      mTracks.SetBreadcrumbLifespan(Lifespan);
 }
 
 void CSymbology::DrawLaserangeFinderReticle(void)
@@ -573,7 +495,7 @@ void CSymbology::DrawCtrLineNortIndicator(void)
    float y_off = 540.0f;
 
    mLine.SetLineMode(SOLID);
-   GLCALL(glLineWidth(2.5));
+   CGlState::LineWidth(2.5f);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    mCompatibility = true;
@@ -622,7 +544,7 @@ void CSymbology::DrawCtrArrowNortIndicator(void)
    mat4 iden(1.0f);
    float space = 50;
 
-   GLCALL(glLineWidth(2.5));
+   CGlState::LineWidth(2.5f);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    float x_off = (0.5f - FromHostAH->los_x_pos) * 960.0f;
@@ -698,7 +620,7 @@ void CSymbology::DrawStandardNorthIndicator(void)
    double rot = 45.0 * 3.1415 / 180.0;
    float wx, wy;
    string msg1("N");
-   CText north(mProjection, 38);
+   CText north(mProjection, mFont38);
    GetTLSection(wx, wy);
    x_off = wx;
    y_off = wy;
@@ -709,7 +631,7 @@ void CSymbology::DrawStandardNorthIndicator(void)
    mat4 iden(1.0f);
    float space = 50;
 
-   GLCALL(glLineWidth(2.5));
+   CGlState::LineWidth(2.5f);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    //
@@ -831,12 +753,34 @@ void CSymbology::DrawNextZoomMarkerGraphic(void)
 
 void CSymbology::UpdateHost(T_FromHostToSymbologyUH *_FromHostUH)
 {
-   memcpy(FromHostUH, _FromHostUH, sizeof(T_FromHostToSymbologyUH));
+   memcpy(&mHostUH.WriteBuffer(), _FromHostUH, sizeof(T_FromHostToSymbologyUH));
+   mHostUH.Publish();
 }
 
 void CSymbology::UpdateHost(T_FromHostToSymbologyAH *_FromHostAH)
 {
-   memcpy(FromHostAH, _FromHostAH, sizeof(T_FromHostToSymbologyAH));
+   memcpy(&mHostAH.WriteBuffer(), _FromHostAH, sizeof(T_FromHostToSymbologyAH));
+   mHostAH.Publish();
+}
+
+void CSymbology::Draw(void)
+{
+   DrawStandardLOSReticle();
+   DrawTrackSymbols();
+   DrawElevationPictograph();
+   DrawAzimuthPictograph();
+   DrawBSCompassTape();
+   DrawStatusMsg();
+}
+
+void CSymbology::LatchHost(void)
+{
+   // one swap each, the writer never touches the buffers read this frame
+   mHostUH.Update();
+   mHostAH.Update();
+
+   FromHostUH = &mHostUH.Read();
+   FromHostAH = &mHostAH.Read();
 }
 
 // Note (0,0) is the top left and (1,1) is the bottom right
@@ -928,7 +872,7 @@ void CSymbology::DrawElevationPointer(void)
    y1 = yoff;
    y2 = y1;
 
-   GLCALL(glLineWidth(3.0));
+   CGlState::LineWidth(3.0f);
    mLine.SetLineMode(SOLID);
 
    x1 = 0.395;
@@ -943,7 +887,7 @@ void CSymbology::DrawElevationPointer(void)
    start = vec3(xoff * (0.5f + x1), yoff, 0.0f);
    end = vec3(xoff * (0.5f + x2) - (tick_size_y1), yoff, 0.0f);
    DrawLine(start, end, mCompatibility);
-   GLCALL(glLineWidth(1.0));
+   CGlState::LineWidth(1.0f);
 }
 
 void CSymbology::DrawElevationValues(void)
@@ -954,7 +898,7 @@ void CSymbology::DrawElevationValues(void)
    float tick_size_y1 = 45;
    const float tick_size_y2 = 63;
    // Figure out Center to next tick
-   CText text(mProjection, 20);
+   CText text(mProjection, mFont20);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    // text width is same as height
@@ -973,7 +917,7 @@ void CSymbology::DrawElevationValues(void)
 
    yoff += yoff * (0.5f + y1) + tick_size_y1 + textWidth + 3;
 
-   GLCALL(glLineWidth(3.0));
+   CGlState::LineWidth(3.0f);
    mLine.SetLineMode(SOLID);
    for (int i = 0; i < 18; ++i)
    {
@@ -997,7 +941,7 @@ void CSymbology::DrawElevationValues(void)
          text.Print(dir, xoff * (0.5f + x2 + 0.02f), mHeight / 2 - (yoff * y1) + textWidth / 2, 1.0f, green);
       }
    }
-   GLCALL(glLineWidth(1.0));
+   CGlState::LineWidth(1.0f);
 }
 
 void CSymbology::DrawAzimuthPointer(void)
@@ -1018,7 +962,7 @@ void CSymbology::DrawAzimuthPointer(void)
    x1 = xoff;
    x2 = x1;
 
-   GLCALL(glLineWidth(3.0));
+   CGlState::LineWidth(3.0f);
    mLine.SetLineMode(SOLID);
 
    y1 = 0.395;
@@ -1033,7 +977,7 @@ void CSymbology::DrawAzimuthPointer(void)
    start = vec3(xoff, yoff * (0.5f + y2), 0.0f);
    end = vec3(xoff, yoff * (0.5f + y2) - (tick_size_y1), 0.0f);
    DrawLine(start, end, mCompatibility);
-   GLCALL(glLineWidth(1.0));
+   CGlState::LineWidth(1.0f);
 }
 
 void CSymbology::DrawAzimuthValues(void)
@@ -1044,7 +988,7 @@ void CSymbology::DrawAzimuthValues(void)
    float tick_size_y1 = 35;
    const float tick_size_y2 = 53;
    // Figure out Center to next tick
-   CText text(mProjection, 20);
+   CText text(mProjection, mFont20);
    vec3 green(0.0f, 1.0f, 0.0f);
 
    int textWidth = 20;
@@ -1062,7 +1006,7 @@ void CSymbology::DrawAzimuthValues(void)
 
    xoff += mInfoBoxMaxWidth / 2;
 
-   GLCALL(glLineWidth(3.0));
+   CGlState::LineWidth(3.0f);
    mLine.SetLineMode(SOLID);
    for (int i = 0; i < 18; ++i)
    {
@@ -1086,18 +1030,13 @@ void CSymbology::DrawAzimuthValues(void)
          text.Print(dir, mWidth / 2 - (xoff * x1) - textWidth, yoff * (0.5f + y2 + 0.02f), 1.0f, green);
       }
    }
-   GLCALL(glLineWidth(1.0));
+   CGlState::LineWidth(1.0f);
 }
 
 void CSymbology::DrawElevationPictograph(void)
 {
-   vec3 start;
-   vec3 end;
-   vec3 prev;
-
    float x1 = 0;
    float y1 = 0;
-   bool first_pass = false;
    float size = 30;
 
    GetMLSection(x1, y1);
@@ -1112,49 +1051,14 @@ void CSymbology::DrawElevationPictograph(void)
    float textWidth = 0.0f;
    float textHeight = 0.0f;
 
-   CText text(mProjection, 28);
+   CText text(mProjection, mFont28);
 
    mLine.SetLineMode(TRIANGLE);
    int elevation = (int)FromHostUH->mt_los_alt;
 
-   start = vec3(x1, y1, 0.0);
-   for (int index = 1; index <= 361; index++)
-   {
-
-      UpdatePoints(x, y, index, size);
-
-      end = vec3(x + x1, y + y1, 0.0);
+   // filled disc with a 30 degree slice cut out at the current elevation
+   mLine.DrawSector(vec3(x1, y1, 0.0f), 0.0f, size, (float)elevation + 30.0f, (float)elevation + 360.0f);
 
-      if (index != elevation)
-      {
-         mLine.Here(end);
-
-         if ((first_pass))
-         {
-            mLine.Here(start);
-            mLine.Here(prev);
-            mLine.Draw();
-         }
-         else
-         {
-            // every 3 verticies draw ttriangle
-            if (!(index % 2))
-            {
-               // add the start
-               mLine.Here(start);
-               mLine.Draw();
-               first_pass = true;
-            }
-         }
-      }
-      else
-      {
-         index += 30; // visible slice
-         UpdatePoints(x, y, index, size);
-         end = vec3(x + x1, y + y1, 0.0);
-      }
-      prev = end;
-   }
    mLine.SetLineMode(SOLID);
 
    // drawing this on top
@@ -1244,7 +1148,7 @@ void CSymbology::DrawTopPictograph(float mx, float my)
    mLine.Draw();
 
    // 1/2 circle black line
-   GLCALL(glLineWidth(2.0));
+   CGlState::LineWidth(2.0f);
    vec4 black(0.0f, 0.0f, 0.0f, 1.0f);
    float x = 0.0f;
    float y = 0.0f;
@@ -1354,13 +1258,8 @@ void CSymbology::DrawTopPictograph(float mx, float my)
 
 void CSymbology::DrawAzimuthPictograph(void)
 {
-   vec3 start;
-   vec3 end;
-   vec3 prev;
-
    float x1 = 0;
    float y1 = 0;
-   bool first_pass = false;
    float size = 30;
 
    GetMLSection(x1, y1);
@@ -1374,49 +1273,13 @@ void CSymbology::DrawAzimuthPictograph(void)
    float textWidth = 0.0f;
    float textHeight = 0.0f;
 
-   CText text(mProjection, 28);
+   CText text(mProjection, mFont28);
 
    mLine.SetLineMode(TRIANGLE);
    int azimuth = (int)FromHostAH->azimuth;
 
-   start = vec3(x1, y1, 0.0);
-   for (int index = 1; index <= 361; index++)
-   {
-
-      UpdatePoints(x, y, index, size);
-
-      end = vec3(x + x1, y + y1, 0.0);
-
-      if (index != azimuth)
-      {
-         mLine.Here(end);
-
-         if ((first_pass))
-         {
-            mLine.Here(start);
-            mLine.Here(prev);
-            mLine.Draw();
-         }
-         else
-         {
-            // every 3 verticies draw ttriangle
-            if (!(index % 2))
-            {
-               // add the start
-               mLine.Here(start);
-               mLine.Draw();
-               first_pass = true;
-            }
-         }
-      }
-      else
-      {
-         index += 30; // visible slice
-         UpdatePoints(x, y, index, size);
-         end = vec3(x + x1, y + y1, 0.0);
-      }
-      prev = end;
-   }
+   // filled disc with a 30 degree slice cut out at the current azimuth
+   mLine.DrawSector(vec3(x1, y1, 0.0f), 0.0f, size, (float)azimuth + 30.0f, (float)azimuth + 360.0f);
 
    mLine.SetLineMode(SOLID);
 
@@ -1447,56 +1310,40 @@ void CSymbology::UpdatePoints(float &x, float &y, int idx, int size)
    y = (float)size * sinf(theta);
 }
 
-void CSymbology::DrawBSCompassTape(void)
+void CSymbology::BuildCompassTape(void)
 {
-   vec3 start;
-   vec3 end;
-   float x1, x2, y1, y2, xoff, yoff;
-   // Figure out Center to next tick
-   CText text(mProjection, 28);
-   vec3 green(0.0f, 1.0f, 0.0f);
-
-   int first_tick_l = ((int)FromHostUH->heading % 10);
-   int first_hdg_l = (int)FromHostUH->heading - 90 - first_tick_l;
-   if (first_hdg_l < 0)
-      first_hdg_l += 360;
-
-   printf("%d %d\n", first_tick_l, first_hdg_l);
-
-   x1 = mBsHeadingDegPerTick * -(90 + first_tick_l);
-   x2 = x1;
+   std::vector<vec3> ticks;
+   float xoff, yoff;
 
    GetBCSection(xoff, yoff);
-   mCompatibility = true;
 
-   mLine.SetLineMode(SOLID);
-   for (int i = 0; i < 18; ++i)
-   {
-      int cur_hdg = first_hdg_l + i * 10;
-      if (cur_hdg > 360)
-         cur_hdg -= 360;
-      x1 += (10 * mBsHeadingDegPerTick);
-      x2 = x1;
-      y1 = (cur_hdg % 30 == 0) ? 0.28 : 0.395;
-      y2 = 0.41;
+   // the strip runs 90 degrees past each end of the compass so any heading
+   // has a full half tape on both sides without wrapping
+   mCompassPixelsPerDeg = xoff * mBsHeadingDegPerTick;
+   mCompassCenterX = xoff * 0.5f;
+   mCompassBottom = yoff * (0.5f + 0.28f) + 32;
+   mCompassLabelY = yoff * (0.5f + 0.41f + 0.02f);
 
-      // glColor4f(0.0, 1.0, 0.0, 1.0);
+   mCompassTicks.ClearVertices();
+   mCompassLabels.Vertices.clear();
 
-      start = vec3(xoff * (0.5f + x1), yoff * (0.5f + y1) + 32, 0.0f);
-      end = vec3(xoff * (0.5f + x2), yoff * (0.5f + y2) + 50, 0.0f);
-
-      DrawLine(start, end, mCompatibility);
+   for (int hdg = -COMPASS_HALF_SPAN; hdg <= 360 + COMPASS_HALF_SPAN; hdg += 10)
+   {
+      int cur_hdg = (hdg + 360) % 360;
+      float x = hdg * mCompassPixelsPerDeg;
+      float y1 = (cur_hdg % 30 == 0) ? 0.28f : 0.395f;
+      float y2 = 0.41f;
 
-      GLCALL(glLineWidth(1.0));
+      ticks.push_back(vec3(x, yoff * (0.5f + y1) + 32, 0.0f));
+      ticks.push_back(vec3(x, yoff * (0.5f + y2) + 50, 0.0f));
 
-      // char dir[4];
-      std::string dir;
       if (cur_hdg % 30 == 0)
       {
+         std::string dir;
+
          switch (cur_hdg)
          {
          case 0:
-         case 360:
             dir = "N";
             break;
          case 90:
@@ -1512,18 +1359,52 @@ void CSymbology::DrawBSCompassTape(void)
             dir = std::to_string(cur_hdg);
             break;
          }
-         text.Print(dir, xoff * (0.5f + x1), yoff * (0.5f + y2 + 0.02f), 1.0f, green);
+         mCompassText.Print(mCompassLabels, dir, x, mCompassLabelY);
       }
    }
 
-   /*
-      glRasterPos2d(0.5,0.5+ 0.35);
-      char hdg[5];
-      sprintf(hdg,"%f",test_hdg);
-      mFontLib.Print(mFontId, hdg);
-   */
+   mCompassTicks.SetLineMode(SOLID);
+   mCompassTicks.SetCompatibility(true);
+   mCompassTicks.AddPixelPoints(ticks.data(), ticks.size());
+   mCompassTicks.CreateVAO();
+
+   mCompassBuilt = true;
+   mCompassFontGeneration = CText::GetFontGeneration();
+}
+
+void CSymbology::DrawBSCompassTape(void)
+{
+   float heading;
+   float left;
+   float right;
+   float top;
+   glm::mat4 model;
+
+   if (!mCompassBuilt || mCompassFontGeneration != CText::GetFontGeneration())
+      BuildCompassTape();
+
+   heading = fmodf(FromHostUH->heading, 360.0f);
+   if (heading < 0)
+      heading += 360.0f;
+
+   // the strip only scrolls, the heading is always at the center of the tape
+   model = glm::translate(glm::mat4(1.0f), vec3(mCompassCenterX - heading * mCompassPixelsPerDeg, 0.0f, 0.0f));
+
+   left = mCompassCenterX - COMPASS_HALF_SPAN * mCompassPixelsPerDeg;
+   right = mCompassCenterX + COMPASS_HALF_SPAN * mCompassPixelsPerDeg;
+   top = mCompassLabelY + mCompassText.GetHeight();
+
+   // anything already queued is drawn unclipped
+   CLine::Flush();
+   CText::Flush();
+
+   CGlState::Scissor((GLint)left, (GLint)mCompassBottom, (GLsizei)(right - left), (GLsizei)(top - mCompassBottom));
+   CGlState::Enable(GL_SCISSOR_TEST);
+
+   mCompassTicks.SetModel(model);
+   mCompassTicks.Draw(false);
+   mCompassText.Draw(mCompassLabels, model);
+   CText::Flush();
 
-   // Draw heading lables
-   // Draw LOS text
-   std::cout << "Heading = " << FromHostUH->heading << std::endl;
+   CGlState::Disable(GL_SCISSOR_TEST);
 }
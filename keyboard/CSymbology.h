@@ -46,6 +46,10 @@
 #include "Line.h"
 #include "CText.h"
 #include "CImage.h"
+#include "SymbolLibrary.h"
+#include "TrackRenderer.h"
+#include "Stopwatch.h"
+#include "TripleBuffer.h"
 
 using namespace std;
 
@@ -66,6 +70,7 @@ using namespace std;
 //
 
 static float mBsHeadingDegPerTick = 0.00220f;
+const int COMPASS_HALF_SPAN = 90; // degrees shown either side of the heading
 
 class CSymbology
 {
@@ -76,6 +81,10 @@ public:
 
    virtual ~CSymbology();
 
+   // follows a window resize in place, the host state, tracks and
+   // breadcrumbs are kept
+   void Resize(glm::mat4 &projection, glm::vec3 &windowSize);
+
    static const float HOST_COORD_X_MAX;
    static const float HOST_COORD_Y_MAX;
 
@@ -91,6 +100,7 @@ public:
 
    // char  mSocketBuffer[SOCKET_BUFFER_SIZE];
 
+   // host state the draw functions read, set by LatchHost()
    T_FromHostToSymbologyAH *FromHostAH;
    T_FromHostToSymbologyUH *FromHostUH;
 
@@ -131,10 +141,23 @@ public:
    void DrawAzimuthPictograph(void);
    void DrawBSCompassTape(void);
    void DrawScaleBarReticle(void);
+   void DrawTrackSymbols(void);
+
+   // MTI box color and breadcrumb settings from the menu, a negative count or
+   // lifespan keeps the current one
+   void SetTrackSettings(eMtiBoxColor BoxColor, bool Breadcrumbs, int MaxBreadcrumbs, float Lifespan);
 
+   // draws the symbology for the host state picked up by LatchHost()
+   void Draw(void);
+
+   // may be called from the network thread, the copy isn't seen by the
+   // draw functions until the next LatchHost()
    void UpdateHost(T_FromHostToSymbologyUH *_FromHostUH);
    void UpdateHost(T_FromHostToSymbologyAH *_FromHostAH);
 
+   // picks up the newest host state, call once at the start of each frame
+   void LatchHost(void);
+
    // for testing
    // void GetVerticies(float& x, float& y, short idx);
    void GetTLSection(float &_X, float &_Y);
@@ -153,6 +176,7 @@ protected:
    float GetTextWidth(std::string &msg);
    void DrawLine(vec3 &start, vec3 &end, bool compat = false);
    void UpdatePoints(float &xin, float &yin, int idx, int size);
+   void BuildCompassTape(void);
    void DrawTopPictograph(float mx, float my);
 
 private:
@@ -171,5 +195,23 @@ private:
    bool mCompatibility = false;
    unsigned int mFontSize;
    CText mText;
+   CText::TFontHandle mFont20;
+   CText::TFontHandle mFont28;
+   CText::TFontHandle mFont38;
    CLine mLine;
+   CLine mCompassTicks;               // tick strip for the whole compass, built once
+   CText mCompassText;
+   CText::TTextBlock mCompassLabels;  // labels for the same strip
+   bool mCompassBuilt = false;
+   unsigned int mCompassFontGeneration = 0;  // labels are rebuilt once their font has loaded
+   float mCompassPixelsPerDeg;
+   float mCompassCenterX;
+   float mCompassBottom;
+   float mCompassLabelY;
+   CSymbolLibrary mSymbols;
+   CTrackRenderer mTracks;
+   eMtiBoxColor mTrackColor = MTI_COLOR_GREEN;
+   CStopwatch mTrackClock;
+   CTripleBuffer<T_FromHostToSymbologyUH> mHostUH;
+   CTripleBuffer<T_FromHostToSymbologyAH> mHostAH;
 };
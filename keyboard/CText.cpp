@@ -1,168 +1,489 @@
 #include "CText.h"
+#include "GlState.h"
 #include <filesystem>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include <stddef.h>
+#include "Stopwatch.h"
 
 CShader *CText::mShader = nullptr;
-std::unordered_map<std::string, CText::Character*> CText::mFonts;
-
-CText::CText(mat4 projection, unsigned int size, const char *Font) : mFont(nullptr),
-                                                                     mFontFileName(Font),
-                                                                     mFontHeight(size),
-                                                                     mProjection(projection),
-                                                                     mInvertY(false),
-                                                                     mTextColor(1.0f)
+std::vector<CText::FontEntry> CText::mFontPool;
+std::unordered_map<std::string, int> CText::mFontIds;
+CText::FontLoader CText::mLoader;
+unsigned int CText::mFontGeneration = 0;
+std::vector<CText::Batch> CText::mBatches;
+GLuint CText::mVbo = 0;
+GLuint CText::mVao = 0;
+size_t CText::mVboCapacity = INITIAL_VBO_GLYPHS * 6;
+
+CText::CText(const mat4& projection, unsigned int size, const char *Font) : mFontId(-1),
+                                                                            mProjection(projection),
+                                                                            mInvertY(false),
+                                                                            mTextColor(1.0f)
 {
-   mFont = GetOrCreateFont();
-
-   // configure VAO/VBO for texture quads
-   // -----------------------------------
-   GLCALL(glGenVertexArrays(1, &mVao));
-   GLCALL(glGenBuffers(1, &mVbo));
-   GLCALL(glBindVertexArray(mVao));
-   GLCALL(glBindBuffer(GL_ARRAY_BUFFER, mVbo));
-   GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW));
-   GLCALL(glEnableVertexAttribArray(0));
-   GLCALL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0));
-   GLCALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-   GLCALL(glBindVertexArray(0));
+   SetFont(GetFont(Font, size).Id);
 }
 
-CText::CText(mat4 projection, unsigned int size) : mFont(nullptr),
-                                                   mFontFileName("fonts//arial.ttf"),
-                                                   mFontHeight(size),
-                                                   mProjection(projection),
-                                                   mInvertY(false),
-                                                   mTextColor(1.0f)
+CText::CText(const mat4& projection, unsigned int size) : mFontId(-1),
+                                                          mProjection(projection),
+                                                          mInvertY(false),
+                                                          mTextColor(1.0f)
 {
-   mFont = GetOrCreateFont();
-
-   // configure VAO/VBO for texture quads
-   // -----------------------------------
-   GLCALL(glGenVertexArrays(1, &mVao));
-   GLCALL(glGenBuffers(1, &mVbo));
-   GLCALL(glBindVertexArray(mVao));
-   GLCALL(glBindBuffer(GL_ARRAY_BUFFER, mVbo));
-   GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW));
-   GLCALL(glEnableVertexAttribArray(0));
-   GLCALL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0));
-   GLCALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-   GLCALL(glBindVertexArray(0));
+   SetFont(GetFont(DEFAULT_FONT, size).Id);
+}
+
+CText::CText(const mat4& projection, TFontHandle Font) : mFontId(-1),
+                                                         mProjection(projection),
+                                                         mInvertY(false),
+                                                         mTextColor(1.0f)
+{
+   SetFont(Font.Id);
 }
 
 CText::~CText()
 {
-   GLCALL(glDeleteVertexArrays(1, &mVao));
-   GLCALL(glDeleteBuffers(1, &mVbo));
 }
 
-CText::Character* CText::GetOrCreateFont()
+void CText::SetFont(int FontId)
+{
+   if (FontId < 0 || FontId >= (int)mFontPool.size())
+      return;
+
+   mFontId = FontId;
+   mFontHeight = mFontPool[FontId].Size;
+   mFontWidth = mFontHeight;
+}
+
+
+CText::TFontHandle CText::GetFont(const char *File, unsigned int Size, bool Wait)
 {
-   // key is font name + font size
-   std::string key = mFontFileName + "_" + std::to_string(mFontHeight);
+   if (!File)
+      File = DEFAULT_FONT;
+
+   std::string key = std::string(File) + "_" + std::to_string(Size);
+   auto        it = mFontIds.find(key);
+
+   if (it != mFontIds.end())
+      return { it->second };
+
+   // failed loads are kept too so they aren't retried every frame
+   int id = (int)mFontPool.size();
 
-   if (mFonts.count(key) == 0)
+   mFontPool.push_back({ File, Size, nullptr, FONT_LOADING, id });
+   mFontIds[key] = id;
+
+   // every size of an SDF font is drawn from the one base size atlas
+   if (FONT_SDF && Size != SDF_BASE_SIZE)
    {
-      mFonts[key] = InitializeFont();
+      int base = GetFont(File, SDF_BASE_SIZE, Wait).Id;
+
+      mFontPool[id].Base = base;
+      return { id };
    }
-   
-   return mFonts[key];
+
+   if (Wait)
+   {
+      std::vector<unsigned char> atlas;
+      Font* glyphs = RasterizeFont(File, Size, atlas);
+
+      FinishFont(id, glyphs, atlas);
+   }
+   else
+   {
+      mLoader.Request(id, File, Size);
+   }
+
+   return { id };
 }
 
-CText::Character* CText::InitializeFont()
+void CText::UploadFonts(double BudgetMs)
 {
-   if (!mShader)
+   CStopwatch timer;
+   FontJob    job;
+
+   timer.Start();
+
+   while (mLoader.Pop(job))
    {
-      mShader = new CShader("text.vs", "text.fs");
-      std::cout << "Created shader " << mShader->mID << " for fonts" << std::endl;
+      FinishFont(job.Id, job.Glyphs, job.Atlas);
+
+      if (timer.GetTime() * 1000.0 >= BudgetMs)
+         break;
    }
+}
 
-   std::cout << "Loading font: " << mFontFileName << " size " << mFontHeight << std::endl;
+void CText::FinishFont(int FontId, Font* Glyphs, const std::vector<unsigned char>& Atlas)
+{
+   FontEntry& entry = mFontPool[FontId];
 
-   if (mFont)
-      delete [] mFont;
-   mFont = new Character[MAX_GLYPHS];
+   if (!Glyphs)
+   {
+      entry.State = FONT_FAILED;
+      return;
+   }
 
-   mUniformTex = 0;
-   mUniformColor = 0;
-   mVbo = 0;
-   mVao = 0;
-   mWindowWidth = 1920.0f;
-   mWindowHeight = 1080.0f;
-   sx = 2.0f / mWindowWidth;
-   sy = 2.0f / mWindowHeight;
-   mFace = nullptr;
+   UploadFont(Glyphs, Atlas);
 
-   /* Initialize the FreeType2 library */
-   if (FT_Init_FreeType(&mFt))
+   entry.Glyphs = Glyphs;
+   entry.State = FONT_READY;
+   mFontGeneration++;
+}
+
+// the requested font, or while it is still loading the closest loaded size
+// with Scale adjusted to match, null if nothing usable is loaded
+const CText::Font* CText::GetGlyphs(float& Scale, bool Fallback) const
+{
+   const FontEntry* fallback = nullptr;
+
+   if (mFontId < 0 || mFontId >= (int)mFontPool.size())
+      return nullptr;
+
+   const FontEntry& entry = mFontPool[mFontId];
+   const FontEntry& base = mFontPool[entry.Base];
+
+   if (base.Glyphs || base.State != FONT_LOADING || !Fallback)
    {
-      fprintf(stderr, "Could not init freetype library\n");
+      if (base.Glyphs)
+         Scale *= (float)entry.Size / (float)base.Size;
+
+      return base.Glyphs;
+   }
+
+   for (const FontEntry& other : mFontPool)
+   {
+      if (!other.Glyphs)
+         continue;
+
+      if (!fallback || abs((int)other.Size - (int)entry.Size) < abs((int)fallback->Size - (int)entry.Size))
+         fallback = &other;
+   }
+
+   if (!fallback)
       return nullptr;
+
+   Scale *= (float)entry.Size / (float)fallback->Size;
+
+   return fallback->Glyphs;
+}
+
+CText::FontLoader::~FontLoader()
+{
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
    }
 
-   /* find path to font
-   std::string font_name = FileSystem::getPath("resources/fonts/Antonio-Bold.ttf");
-   if (font_name.empty())
+   mWake.notify_one();
+
+   if (mThread.joinable())
+      mThread.join();
+
+   for (FontJob& job : mDone)
+      delete job.Glyphs;
+}
+
+void CText::FontLoader::Request(int Id, const char *File, unsigned int Size)
+{
    {
-      std::cout << "ERROR::FREETYPE: Failed to load font_name" << std::endl;
-      return -1;
+      std::lock_guard<std::mutex> lock(mMutex);
+
+      mPending.push_back({ Id, File, Size, nullptr, {} });
+
+      if (!mThread.joinable())
+         mThread = std::thread(&FontLoader::Run, this);
    }
-   */
+
+   mWake.notify_one();
+}
+
+bool CText::FontLoader::Pop(FontJob& Job)
+{
+   std::lock_guard<std::mutex> lock(mMutex);
+
+   if (mDone.empty())
+      return false;
+
+   Job = std::move(mDone.front());
+   mDone.pop_front();
+
+   return true;
+}
+
+void CText::FontLoader::Run()
+{
+   for (;;)
+   {
+      FontJob job;
+
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+
+         while (!mStop && mPending.empty())
+            mWake.wait(lock);
+
+         if (mStop)
+            return;
+
+         job = std::move(mPending.front());
+         mPending.pop_front();
+      }
+
+      // FreeType only, no GL on this thread
+      job.Glyphs = RasterizeFont(job.FileName.c_str(), job.Size, job.Atlas);
+
+      {
+         std::lock_guard<std::mutex> lock(mMutex);
+         mDone.push_back(std::move(job));
+      }
+   }
+}
+
+// squared distance transform of one row or column of Grid in place
+// (Felzenszwalb & Huttenlocher), F/D/V/Z are scratch space of Count + 1
+static void DistanceTransform(double* Grid, int Count, int Stride, double* F, double* D, int* V, double* Z)
+{
+   int k = 0;
+
+   for (int i = 0; i < Count; i++)
+      F[i] = Grid[i * Stride];
+
+   V[0] = 0;
+   Z[0] = -SDF_INFINITY;
+   Z[1] = SDF_INFINITY;
+
+   // lower envelope of the parabolas rooted at each sample
+   for (int q = 1; q < Count; q++)
+   {
+      double s;
+
+      do
+      {
+         int r = V[k];
+         s = ((F[q] + q * q) - (F[r] + r * r)) / (2 * q - 2 * r);
+      } while (s <= Z[k] && --k >= 0);
+
+      k++;
+      V[k] = q;
+      Z[k] = s;
+      Z[k + 1] = SDF_INFINITY;
+   }
+
+   k = 0;
+   for (int q = 0; q < Count; q++)
+   {
+      while (Z[k + 1] < q)
+         k++;
+
+      D[q] = (double)(q - V[k]) * (q - V[k]) + F[V[k]];
+   }
+
+   for (int i = 0; i < Count; i++)
+      Grid[i * Stride] = D[i];
+}
+
+static void DistanceTransform(std::vector<double>& Grid, int Width, int Height)
+{
+   int                 count = std::max(Width, Height);
+   std::vector<double> f(count + 1), d(count + 1), z(count + 2);
+   std::vector<int>    v(count + 1);
+
+   for (int x = 0; x < Width; x++)
+      DistanceTransform(&Grid[x], Height, Width, f.data(), d.data(), v.data(), z.data());
+
+   for (int y = 0; y < Height; y++)
+      DistanceTransform(&Grid[y * Width], Width, 1, f.data(), d.data(), v.data(), z.data());
+}
+
+// converts an antialiased coverage bitmap to a distance field SDF_SPREAD
+// pixels larger on every side, 128 is the edge and 255 is deep inside
+void CText::BuildSdf(const unsigned char* Coverage, int Width, int Height, int Pitch, std::vector<unsigned char>& Sdf)
+{
+   int                 width = Width + SDF_SPREAD * 2;
+   int                 height = Height + SDF_SPREAD * 2;
+   std::vector<double> outside(width * height, SDF_INFINITY);
+   std::vector<double> inside(width * height, 0.0);
+
+   // partially covered pixels seed a sub-pixel distance to the edge
+   for (int y = 0; y < Height; y++)
+   {
+      for (int x = 0; x < Width; x++)
+      {
+         double a = Coverage[y * Pitch + x] / 255.0;
+         size_t i = (y + SDF_SPREAD) * width + x + SDF_SPREAD;
+
+         if (a >= 1.0)
+         {
+            outside[i] = 0.0;
+            inside[i] = SDF_INFINITY;
+         }
+         else if (a > 0.0)
+         {
+            outside[i] = pow(std::max(0.0, 0.5 - a), 2.0);
+            inside[i] = pow(std::max(0.0, a - 0.5), 2.0);
+         }
+      }
+   }
+
+   DistanceTransform(outside, width, height);
+   DistanceTransform(inside, width, height);
+
+   Sdf.resize(width * height);
+
+   for (size_t i = 0; i < Sdf.size(); i++)
+   {
+      double distance = sqrt(outside[i]) - sqrt(inside[i]);
+      double value = 0.5 - distance / (2.0 * SDF_SPREAD);
+
+      Sdf[i] = (unsigned char)(std::min(std::max(value, 0.0), 1.0) * 255.0);
+   }
+}
+
+// renders the first 128 characters and packs them into a single channel atlas,
+// safe to call from any thread since each call has its own FreeType library
+CText::Font* CText::RasterizeFont(const char *File, unsigned int Size, std::vector<unsigned char>& Atlas)
+{
+   FT_Library ft;
+   FT_Face    face = nullptr;
+
+   /* Initialize the FreeType2 library */
+   if (FT_Init_FreeType(&ft))
+   {
+      fprintf(stderr, "Could not init freetype library\n");
+      return nullptr;
+   }
+
    /* Load a font */
-   if (FT_New_Face(mFt, mFontFileName.c_str(), 0, &mFace))
+   if (FT_New_Face(ft, File, 0, &face))
    {
-      fprintf(stderr, "Could not open font %s\n", mFontFileName.c_str());
+      fprintf(stderr, "Could not open font %s\n", File);
+      FT_Done_FreeType(ft);
       return nullptr;
    }
 
    // set size to load glyphs as
-   mFontWidth = mFontHeight;
-   FT_Set_Pixel_Sizes(mFace, mFontWidth, mFontHeight);
+   FT_Set_Pixel_Sizes(face, Size, Size);
 
-   // disable byte-alignment restriction
-   GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+   Font* font = new Font{};
+   std::vector<unsigned char> bitmaps[MAX_GLYPHS];
+   ivec2 offsets[MAX_GLYPHS];
+   int x = ATLAS_PADDING;
+   int y = ATLAS_PADDING;
+   int row_height = 0;
 
-   // load first 128 characters of ASCII set
+   // load first 128 characters of ASCII set and pack them into rows of the atlas
    for (unsigned char c = 0; c < MAX_GLYPHS; c++)
    {
       // Load character glyph
-      if (FT_Load_Char(mFace, c, FT_LOAD_RENDER))
+      if (FT_Load_Char(face, c, FT_LOAD_RENDER))
       {
-         std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+         fprintf(stderr, "Could not load glyph %d from font %s\n", (int)c, File);
+
+         // leave an empty glyph so the atlas pass below has nothing to copy
+         offsets[c] = ivec2(0, 0);
+         font->Glyphs[c] = { ivec2(0, 0), ivec2(0, 0), 0, vec2(0.0f), vec2(0.0f) };
          continue;
       }
-      // generate texture
-      unsigned int texture;
-      GLCALL(glGenTextures(1, &texture));
-      GLCALL(glBindTexture(GL_TEXTURE_2D, texture));
-      GLCALL(glTexImage2D(
-          GL_TEXTURE_2D,
-          0,
-          GL_RED,
-          mFace->glyph->bitmap.width,
-          mFace->glyph->bitmap.rows,
-          0,
-          GL_RED,
-          GL_UNSIGNED_BYTE,
-          mFace->glyph->bitmap.buffer));
-      // set texture options
-      GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-      GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-      GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-      GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+
+      FT_Bitmap& bitmap = face->glyph->bitmap;
+      int        width = (int)bitmap.width;
+      int        height = (int)bitmap.rows;
+      ivec2      bearing(face->glyph->bitmap_left, face->glyph->bitmap_top);
+
+      if (FONT_SDF && width > 0 && height > 0)
+      {
+         // the field extends SDF_SPREAD pixels past the coverage on every side
+         BuildSdf(bitmap.buffer, width, height, bitmap.pitch, bitmaps[c]);
+         width += SDF_SPREAD * 2;
+         height += SDF_SPREAD * 2;
+         bearing += ivec2(-SDF_SPREAD, SDF_SPREAD);
+      }
+
+      // start a new row if this glyph doesn't fit on the current one
+      if (x + width + ATLAS_PADDING > ATLAS_WIDTH)
+      {
+         x = ATLAS_PADDING;
+         y += row_height + ATLAS_PADDING;
+         row_height = 0;
+      }
+
+      // keep a copy of the bitmap, FreeType reuses the glyph slot on the next load
+      if (bitmaps[c].empty())
+      {
+         bitmaps[c].resize(width * height);
+         for (int row = 0; row < height; row++)
+            memcpy(&bitmaps[c][row * width], bitmap.buffer + row * bitmap.pitch, width);
+      }
+
+      offsets[c] = ivec2(x, y);
+
       // now store character for later use
       Character character = {
-          texture,
-          glm::ivec2(mFace->glyph->bitmap.width, mFace->glyph->bitmap.rows),
-          glm::ivec2(mFace->glyph->bitmap_left, mFace->glyph->bitmap_top),
-          static_cast<unsigned int>(mFace->glyph->advance.x)};
+          glm::ivec2(width, height),
+          bearing,
+          static_cast<unsigned int>(face->glyph->advance.x),
+          glm::vec2(0.0f),
+          glm::vec2(0.0f)};
+
+      font->Glyphs[c] = character;
 
-      mFont[c] = character;
+      x += width + ATLAS_PADDING;
+      row_height = std::max(row_height, height);
    }
-   GLCALL(glBindTexture(GL_TEXTURE_2D, 0));
+
    // destroy FreeType once we're finished
-   FT_Done_Face(mFace);
-   FT_Done_FreeType(mFt);
+   FT_Done_Face(face);
+   FT_Done_FreeType(ft);
+
+   // copy all glyphs into a single atlas
+   font->AtlasSize = ivec2(ATLAS_WIDTH, y + row_height + ATLAS_PADDING);
 
-   return mFont;
+   Atlas.assign(font->AtlasSize.x * font->AtlasSize.y, 0);
+
+   for (int c = 0; c < MAX_GLYPHS; c++)
+   {
+      Character& ch = font->Glyphs[c];
+
+      for (int row = 0; row < ch.Size.y; row++)
+         memcpy(&Atlas[(offsets[c].y + row) * font->AtlasSize.x + offsets[c].x], &bitmaps[c][row * ch.Size.x], ch.Size.x);
+
+      ch.TexMin = vec2((float)offsets[c].x / font->AtlasSize.x, (float)offsets[c].y / font->AtlasSize.y);
+      ch.TexMax = vec2((float)(offsets[c].x + ch.Size.x) / font->AtlasSize.x, (float)(offsets[c].y + ch.Size.y) / font->AtlasSize.y);
+   }
+
+   return font;
+}
+
+void CText::UploadFont(Font* Glyphs, const std::vector<unsigned char>& Atlas)
+{
+   if (!mShader)
+   {
+      mShader = new CShader("text.vs", "text.fs");
+      std::cout << "Created shader " << mShader->mID << " for fonts" << std::endl;
+   }
+
+   // disable byte-alignment restriction
+   GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+   // generate texture
+   GLCALL(glGenTextures(1, &Glyphs->TextureID));
+   CGlState::BindTexture(GL_TEXTURE_2D, Glyphs->TextureID);
+   GLCALL(glTexImage2D(
+       GL_TEXTURE_2D,
+       0,
+       GL_RED,
+       Glyphs->AtlasSize.x,
+       Glyphs->AtlasSize.y,
+       0,
+       GL_RED,
+       GL_UNSIGNED_BYTE,
+       Atlas.data()));
+   // set texture options
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 }
 
 /**
@@ -174,107 +495,208 @@ void CText::Print(string &text, float x, float y, float scale, glm::vec3 color)
 {
    // activate corresponding render state
    SetColor(color);
-   Print(text.c_str(), x, y, scale);
+   Print(std::string_view(text), x, y, scale);
 }
 
 float CText::Print(const char *Text, float X, float Y, float Scale)
 {
-   float x = X;
+   if (!Text)
+      return 0;
 
-   if (!Text || !mFont)
+   return Print(std::string_view(Text), X, Y, Scale);
+}
+
+std::vector<CText::Point>& CText::GetBatch(unsigned int TextureID, const mat4& Projection)
+{
+   // strings sharing an atlas and projection go in the same batch
+   for (Batch& batch : mBatches)
+   {
+      if (batch.TextureID == TextureID && batch.Projection == Projection)
+         return batch.Vertices;
+   }
+
+   mBatches.push_back({TextureID, Projection, {}});
+   mBatches.back().Vertices.reserve(INITIAL_VBO_GLYPHS * 6);
+
+   return mBatches.back().Vertices;
+}
+
+float CText::Print(std::string_view Text, float X, float Y, float Scale)
+{
+   const Font* glyphs = GetGlyphs(Scale);
+
+   if (Text.empty() || !glyphs)
       return 0;
 
-   // activate corresponding render state
-   mShader->use();
-   mShader->setMat4("projection", mProjection);
-   mShader->setVec3("textColor", mTextColor);
+   // append the quads for the whole string to the frame queue
+   return Layout(glyphs, GetBatch(glyphs->TextureID, mProjection), Text, X, Y, Scale);
+}
 
-   GLCALL(glActiveTexture(GL_TEXTURE0));
-   GLCALL(glBindVertexArray(mVao));
+float CText::Print(TTextBlock& Block, std::string_view Text, float X, float Y, float Scale)
+{
+   // blocks are kept, so never lay one out with a fallback font
+   const Font* glyphs = GetGlyphs(Scale, false);
 
-   // iterate through all characters
-   for (size_t i = 0; i < strlen(Text); i++)
+   if (Text.empty() || !glyphs)
+      return 0;
+
+   // a block only ever references one atlas
+   if (Block.Vertices.empty())
+      Block.TextureID = glyphs->TextureID;
+   else if (Block.TextureID != glyphs->TextureID)
+      return 0;
+
+   return Layout(glyphs, Block.Vertices, Text, X, Y, Scale);
+}
+
+void CText::Draw(const TTextBlock& Block, const mat4& Model)
+{
+   if (Block.Vertices.empty())
+      return;
+
+   std::vector<Point>& vertices = GetBatch(Block.TextureID, mProjection * Model);
+
+   vertices.insert(vertices.end(), Block.Vertices.begin(), Block.Vertices.end());
+}
+
+// 6 vertices per glyph in the current font and color, returns the advance
+float CText::Layout(const Font* Glyphs, std::vector<Point>& Vertices, std::string_view Text, float X, float Y, float Scale)
+{
+   float x = X;
+   float r = mTextColor.r;
+   float g = mTextColor.g;
+   float b = mTextColor.b;
+
+   Vertices.reserve(Vertices.size() + Text.size() * 6);
+
+   for (char c : Text)
    {
-      int ch_idx = Text[i];
-      if (ch_idx < 0 || ch_idx > MAX_GLYPHS)
+      int ch_idx = c;
+      if (ch_idx < 0 || ch_idx >= MAX_GLYPHS)
          continue;
 
-      Character ch = mFont[ch_idx];
+      const Character& ch = Glyphs->Glyphs[ch_idx];
 
       float xpos = x + ch.Bearing.x * Scale;
       float ypos = Y - (ch.Size.y - ch.Bearing.y) * Scale;
-
-      if (mInvertY)
-         ypos = Y - ch.Bearing.y * Scale;
-
       float w = ch.Size.x * Scale;
       float h = ch.Size.y * Scale;
-      // update VBO for each character
+
+      // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+      x += (ch.Advance >> 6) * Scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+
+      // nothing to draw for blank glyphs (spaces)
+      if (ch.Size.x == 0 || ch.Size.y == 0)
+         continue;
+
       if (mInvertY)
       {
-         float vertices[6][4] = {
-             {xpos, ypos + h, 0.0f, 1.0f},
-             {xpos, ypos, 0.0f, 0.0f},
-             {xpos + w, ypos, 1.0f, 0.0f},
-
-             {xpos, ypos + h, 0.0f, 1.0f},
-             {xpos + w, ypos, 1.0f, 0.0f},
-             {xpos + w, ypos + h, 1.0f, 1.0f}};
-
-         // render glyph texture over quad
-         GLCALL(glBindTexture(GL_TEXTURE_2D, ch.TextureID));
-         // update content of VBO memory
-         GLCALL(glBindBuffer(GL_ARRAY_BUFFER, mVbo));
-         GLCALL(glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices)); // be sure to use glBufferSubData and not glBufferData
+         ypos = Y - ch.Bearing.y * Scale;
+
+         Vertices.push_back({xpos, ypos + h, ch.TexMin.x, ch.TexMax.y, r, g, b});
+         Vertices.push_back({xpos, ypos, ch.TexMin.x, ch.TexMin.y, r, g, b});
+         Vertices.push_back({xpos + w, ypos, ch.TexMax.x, ch.TexMin.y, r, g, b});
+
+         Vertices.push_back({xpos, ypos + h, ch.TexMin.x, ch.TexMax.y, r, g, b});
+         Vertices.push_back({xpos + w, ypos, ch.TexMax.x, ch.TexMin.y, r, g, b});
+         Vertices.push_back({xpos + w, ypos + h, ch.TexMax.x, ch.TexMax.y, r, g, b});
       }
       else
       {
-         float vertices[6][4] = {
-             {xpos, ypos + h, 0.0f, 0.0f},
-             {xpos, ypos, 0.0f, 1.0f},
-             {xpos + w, ypos, 1.0f, 1.0f},
-
-             {xpos, ypos + h, 0.0f, 0.0f},
-             {xpos + w, ypos, 1.0f, 1.0f},
-             {xpos + w, ypos + h, 1.0f, 0.0f}};
-
-         // render glyph texture over quad
-         GLCALL(glBindTexture(GL_TEXTURE_2D, ch.TextureID));
-         // update content of VBO memory
-         GLCALL(glBindBuffer(GL_ARRAY_BUFFER, mVbo));
-         GLCALL(glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices)); // be sure to use glBufferSubData and not glBufferData
-      }
+         Vertices.push_back({xpos, ypos + h, ch.TexMin.x, ch.TexMin.y, r, g, b});
+         Vertices.push_back({xpos, ypos, ch.TexMin.x, ch.TexMax.y, r, g, b});
+         Vertices.push_back({xpos + w, ypos, ch.TexMax.x, ch.TexMax.y, r, g, b});
 
-      GLCALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-      // render quad
-      GLCALL(glDrawArrays(GL_TRIANGLES, 0, 6));
-      // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-      x += (ch.Advance >> 6) * Scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+         Vertices.push_back({xpos, ypos + h, ch.TexMin.x, ch.TexMin.y, r, g, b});
+         Vertices.push_back({xpos + w, ypos, ch.TexMax.x, ch.TexMax.y, r, g, b});
+         Vertices.push_back({xpos + w, ypos + h, ch.TexMax.x, ch.TexMin.y, r, g, b});
+      }
    }
-   GLCALL(glBindVertexArray(0));
-   GLCALL(glBindTexture(GL_TEXTURE_2D, 0));
 
    // return width of displayed text
    return (x - X);
 }
 
+void CText::Flush()
+{
+   if (!mShader || mBatches.empty())
+      return;
+
+   // configure the shared VAO/VBO for texture quads on first use
+   // -----------------------------------------------------------
+   if (!mVao)
+   {
+      GLCALL(glGenVertexArrays(1, &mVao));
+      GLCALL(glGenBuffers(1, &mVbo));
+      CGlState::BindVertexArray(mVao);
+      CGlState::BindBuffer(GL_ARRAY_BUFFER, mVbo);
+      GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(Point) * mVboCapacity, NULL, GL_DYNAMIC_DRAW));
+      GLCALL(glEnableVertexAttribArray(0));
+      GLCALL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Point), (void*)offsetof(Point, x)));
+      GLCALL(glEnableVertexAttribArray(1));
+      GLCALL(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Point), (void*)offsetof(Point, r)));
+   }
+
+   // activate corresponding render state
+   mShader->use();
+   mShader->setBool("sdf", FONT_SDF);
+
+   CGlState::ActiveTexture(GL_TEXTURE0);
+   CGlState::BindVertexArray(mVao);
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, mVbo);
+
+   for (size_t i = 0; i < mBatches.size(); )
+   {
+      Batch& batch = mBatches[i];
+
+      // drop batches that weren't used this frame (e.g. after a resize)
+      if (batch.Vertices.empty())
+      {
+         mBatches.erase(mBatches.begin() + i);
+         continue;
+      }
+
+      mShader->setMat4("projection", batch.Projection);
+      CGlState::BindTexture(GL_TEXTURE_2D, batch.TextureID);
+
+      // grow the VBO if this batch doesn't fit, otherwise orphan the old contents
+      if (batch.Vertices.size() > mVboCapacity)
+         mVboCapacity = batch.Vertices.size();
+      GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(Point) * mVboCapacity, NULL, GL_DYNAMIC_DRAW));
+
+      // update content of VBO memory and render all quads at once
+      GLCALL(glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Point) * batch.Vertices.size(), batch.Vertices.data()));
+      GLCALL(glDrawArrays(GL_TRIANGLES, 0, (GLsizei)batch.Vertices.size()));
+
+      batch.Vertices.clear();
+      i++;
+   }
+}
+
 float CText::GetWidth(const char *Text, float Scale)
+{
+   if (!Text)
+      return 0;
+
+   return GetWidth(std::string_view(Text), Scale);
+}
+
+float CText::GetWidth(std::string_view Text, float Scale)
 {
    float width = 0;
+   const Font* glyphs = GetGlyphs(Scale);
 
-   if (!Text || !mFont)
+   if (!glyphs)
       return 0;
 
    // iterate through all characters
-   for (size_t i = 0; i < strlen(Text); i++)
+   for (char c : Text)
    {
-      int ch_idx = Text[i];
-      if (ch_idx < 0 || ch_idx > MAX_GLYPHS)
+      int ch_idx = c;
+      if (ch_idx < 0 || ch_idx >= MAX_GLYPHS)
          continue;
 
-      Character ch = mFont[ch_idx];
-
-      width += (ch.Advance >> 6) * Scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+      width += (glyphs->Glyphs[ch_idx].Advance >> 6) * Scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
    }
 
    return width;
@@ -5,7 +5,14 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
 #include <unordered_map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <ft2build.h>
 #include "CShaderUtils.h"
 #include FT_FREETYPE_H
@@ -14,9 +21,29 @@ using namespace std;
 using namespace glm;
 
 const int MAX_GLYPHS = 128;
+const int ATLAS_WIDTH = 1024;
+const int ATLAS_PADDING = 1; // keeps linear filtering from bleeding between glyphs
+const int INITIAL_VBO_GLYPHS = 64;
+const char* const DEFAULT_FONT = "fonts//arial.ttf";
+const double FONT_UPLOAD_BUDGET_MS = 2.0; // atlas uploads per frame stop after this
+
+// signed distance field glyphs, one atlas per font file rendered at
+// SDF_BASE_SIZE serves every size, text.fs rebuilds the edge when drawing
+const bool FONT_SDF = true;
+const unsigned int SDF_BASE_SIZE = 64;
+const int SDF_SPREAD = 8;                  // pixels of distance kept around each glyph
+const double SDF_INFINITY = 1e20;
 
 class CText
 {
+public:
+
+   // id of a loaded font file/size, cheap to copy and to construct a CText from
+   struct TFontHandle
+   {
+      int Id;
+   };
+
 private:
    
    struct Point
@@ -25,39 +52,109 @@ private:
       GLfloat y;
       GLfloat s;
       GLfloat t;
+      GLfloat r; // color is per-vertex so strings with different colors
+      GLfloat g; // can share a draw call
+      GLfloat b;
+   };
+
+   // Glyph quads queued this frame for a single atlas/projection pair
+   struct Batch
+   {
+      unsigned int TextureID;
+      mat4 Projection;
+      std::vector<Point> Vertices;
    };
 
    // Holds all state information relevant to a character as loaded using FreeType
    struct Character
    {
-      unsigned int TextureID; // ID handle of the glyph texture
       ivec2 Size;             // Size of glyph
       ivec2 Bearing;          // Offset from baseline to left/top of glyph
       unsigned int Advance;   // Horizontal offset to advance to next glyph
+      vec2 TexMin;            // Top left corner of the glyph in the font atlas (s, t)
+      vec2 TexMax;            // Bottom right corner of the glyph in the font atlas (s, t)
+   };
+
+   // Holds the atlas texture and glyph metrics for a font file/size
+   struct Font
+   {
+      unsigned int TextureID; // ID handle of the atlas texture holding all glyphs
+      ivec2 AtlasSize;        // Size of the atlas texture in pixels
+      Character Glyphs[MAX_GLYPHS];
+   };
+
+   enum eFontState
+   {
+      FONT_LOADING,
+      FONT_READY,
+      FONT_FAILED
+   };
+
+   // a font file/size that has been requested, Glyphs is null until it is
+   // ready, sizes that share an SDF atlas only hold the id of its Base entry
+   struct FontEntry
+   {
+      std::string FileName;
+      unsigned int Size;
+      Font* Glyphs;
+      eFontState State;
+      int Base;
+   };
+
+   // a font for the loader thread, Glyphs and Atlas are filled in by it
+   struct FontJob
+   {
+      int Id;
+      std::string FileName;
+      unsigned int Size;
+      Font* Glyphs;
+      std::vector<unsigned char> Atlas;
+   };
+
+   // rasterizes fonts with FreeType on its own thread, the atlas upload is
+   // left to the render thread in UploadFonts()
+   class FontLoader
+   {
+   public:
+      ~FontLoader();
+
+      void Request(int Id, const char *File, unsigned int Size);
+      bool Pop(FontJob& Job);
+
+   private:
+      void Run();
+
+      std::thread             mThread;
+      std::mutex              mMutex;
+      std::condition_variable mWake;
+      std::deque<FontJob>     mPending;
+      std::deque<FontJob>     mDone;
+      bool                    mStop = false;
    };
 
    static CShader *mShader;
 
-   Character* GetOrCreateFont();
-
-   //Character Characters[MAX_GLYPHS];
-   Character* mFont;
-   static std::unordered_map<std::string, Character*> mFonts; // holds array of textures for each unique font file
-
-   GLint mAttributeCoord;
-   GLint mUniformTex;
-   GLint mUniformColor;
-   Point mPoint;
-   GLuint mVbo;
-   GLuint mVao;
-   float mWindowWidth;
-   float mWindowHeight;
-
-   FT_Library mFt;
-   FT_Face mFace;
-   string mFontFileName;
-   float sx = 0.0f;
-   float sy = 0.0f;
+   static Font* RasterizeFont(const char *File, unsigned int Size, std::vector<unsigned char>& Atlas);
+   static void UploadFont(Font* Glyphs, const std::vector<unsigned char>& Atlas);
+   static void FinishFont(int FontId, Font* Glyphs, const std::vector<unsigned char>& Atlas);
+   static void BuildSdf(const unsigned char* Coverage, int Width, int Height, int Pitch, std::vector<unsigned char>& Sdf);
+
+   int mFontId;
+   static std::vector<FontEntry> mFontPool;                // every font ever requested, indexed by id
+   static std::unordered_map<std::string, int> mFontIds;  // file_size to pool id
+   static FontLoader mLoader;
+   static unsigned int mFontGeneration;
+
+   static std::vector<Batch> mBatches; // frame-wide text queue shared by all instances
+   static GLuint mVbo;
+   static GLuint mVao;
+   static size_t mVboCapacity;         // number of vertices the VBO can hold
+
+   std::vector<Point>& GetBatch(unsigned int TextureID, const mat4& Projection);
+   const Font* GetGlyphs(float& Scale, bool Fallback = true) const;
+   float Layout(const Font* Glyphs, std::vector<Point>& Vertices, std::string_view Text, float X, float Y, float Scale);
+   void SetFont(int FontId);
+
    unsigned int mFontHeight = 48;
    unsigned int mFontWidth = 48;
    mat4 mProjection;
@@ -65,12 +162,38 @@ private:
    glm::vec3 mTextColor;
 
 public:
-   CText(mat4 projection, unsigned int size);
-   CText(mat4 projection, unsigned int size, const char *Font);
+
+   // glyph quads laid out once and queued again every frame with only a
+   // transform, for text that never changes (tape labels, fixed legends)
+   struct TTextBlock
+   {
+      unsigned int TextureID = 0;
+      std::vector<Point> Vertices;
+   };
+
+   CText(const mat4& projection, unsigned int size);
+   CText(const mat4& projection, unsigned int size, const char *Font);
+   CText(const mat4& projection, TFontHandle Font);
    ~CText();
 
-   Character* InitializeFont();
-   bool IsInitialized() const { return (mFont != nullptr); }
+   // queues the font for the loader thread on first use, later calls are a
+   // hash lookup, Wait loads it on this thread instead (startup only)
+   static TFontHandle GetFont(const char *File, unsigned int Size, bool Wait = false);
+
+   // uploads the fonts the loader thread has finished, call once a frame on
+   // the render thread, at least one font is uploaded per call
+   static void UploadFonts(double BudgetMs = FONT_UPLOAD_BUDGET_MS);
+
+   // changes every time a font becomes ready, anything measured while its
+   // font was still loading used a fallback and should be measured again
+   static unsigned int GetFontGeneration() { return mFontGeneration; }
+
+   // false only if the font failed to load, a font that is still loading
+   // draws with the closest loaded size until it is ready
+   bool IsInitialized() const
+   {
+      return (mFontId >= 0 && mFontId < (int)mFontPool.size() && mFontPool[mFontPool[mFontId].Base].State != FONT_FAILED);
+   }
 
    void Test();
 
@@ -84,20 +207,14 @@ public:
       return mFontHeight;
    }
 
-   void SetWindowSize(float w, float h)
-   {
-      mWindowWidth = w;
-      mWindowHeight = h;
-   }
-
    void SetFontFileName(string &font)
    {
-      mFontFileName = font;
+      SetFont(GetFont(font.c_str(), mFontHeight).Id);
    }
 
    void SetFontSize(unsigned int size)
    {
-      mFontHeight = size;
+      SetFont(GetFont(IsInitialized() ? mFontPool[mFontId].FileName.c_str() : DEFAULT_FONT, size).Id);
    }
 
    unsigned int GetFontSize() { return mFontHeight; }
@@ -121,9 +238,24 @@ public:
 
    void SetInvertY(bool Invert) { mInvertY = Invert; }
 
+   // draws all text queued by every CText instance, one draw per atlas/projection
+   static void Flush();
+
    void Print(string &text, float x, float y, float scale, vec3 color);
 
    float Print(const char *Text, float X, float Y, float Scale = 1.0f);
 
+   // queues the quads for the whole string, they are drawn on the next Flush()
+   float Print(std::string_view Text, float X, float Y, float Scale = 1.0f);
+
+   // lays the string out into Block instead of the frame queue, every
+   // string in a block has to use the same font and nothing is added while
+   // that font is still loading
+   float Print(TTextBlock& Block, std::string_view Text, float X, float Y, float Scale = 1.0f);
+
+   // queues a prebuilt block, Model is applied before the projection
+   void Draw(const TTextBlock& Block, const mat4& Model);
+
    float GetWidth(const char *Text, float Scale = 1.0f);
+   float GetWidth(std::string_view Text, float Scale = 1.0f);
 };
@@ -0,0 +1,338 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      GlState
+//! Class:      CPP Source
+//! Filename:   GlState.cpp
+//! Author:     Brian Woodard
+//! Purpose:    Tracks bound GL state so redundant binds can be skipped.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "GlState.h"
+
+bool         CGlState::mKnown[STATE_COUNT] = {};
+GLuint       CGlState::mProgram = 0;
+GLuint       CGlState::mVao = 0;
+GLuint       CGlState::mArrayBuffer = 0;
+GLenum       CGlState::mActiveUnit = GL_TEXTURE0;
+GLuint       CGlState::mTextures[GL_STATE_TEXTURE_UNITS] = {};
+float        CGlState::mLineWidth = 1.0f;
+bool         CGlState::mCaps[STATE_SCISSOR_TEST - STATE_BLEND + 1] = {};
+GLenum       CGlState::mStencilFunc = GL_ALWAYS;
+GLint        CGlState::mStencilRef = 0;
+GLuint       CGlState::mStencilFuncMask = ~0u;
+GLenum       CGlState::mStencilOp[3] = { GL_KEEP, GL_KEEP, GL_KEEP };
+GLuint       CGlState::mStencilMask = ~0u;
+GLboolean    CGlState::mColorMask[4] = { GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE };
+GLboolean    CGlState::mDepthMask = GL_TRUE;
+GLint        CGlState::mScissorBox[4] = { 0, 0, 0, 0 };
+GLuint       CGlState::mFramebuffer = 0;
+GLenum       CGlState::mBlendFunc[4] = { GL_ONE, GL_ZERO, GL_ONE, GL_ZERO };
+unsigned int CGlState::mCallsAvoided = 0;
+
+// nothing is known until it has been set through here once
+void CGlState::Invalidate()
+{
+   memset(mKnown, 0, sizeof(mKnown));
+}
+
+// returns true (and counts it) if the state is known and already current,
+// otherwise marks it known since the caller is about to set it
+bool CGlState::Skip(int State, bool Current)
+{
+   if (mKnown[State] && Current)
+   {
+      mCallsAvoided++;
+      return true;
+   }
+
+   mKnown[State] = true;
+   return false;
+}
+
+int CGlState::CapState(GLenum Cap)
+{
+   switch (Cap)
+   {
+      case GL_BLEND:        return STATE_BLEND;
+      case GL_STENCIL_TEST: return STATE_STENCIL_TEST;
+      case GL_DEPTH_TEST:   return STATE_DEPTH_TEST;
+      case GL_SCISSOR_TEST: return STATE_SCISSOR_TEST;
+      default:              return -1;
+   }
+}
+
+void CGlState::UseProgram(GLuint Program)
+{
+   if (Skip(STATE_PROGRAM, mProgram == Program))
+      return;
+
+   GLCALL(glUseProgram(Program));
+   mProgram = Program;
+}
+
+void CGlState::BindVertexArray(GLuint Vao)
+{
+   if (Skip(STATE_VAO, mVao == Vao))
+      return;
+
+   GLCALL(glBindVertexArray(Vao));
+   mVao = Vao;
+}
+
+void CGlState::BindBuffer(GLenum Target, GLuint Buffer)
+{
+   // element array bindings belong to the VAO, only the array buffer is tracked
+   if (Target != GL_ARRAY_BUFFER)
+   {
+      GLCALL(glBindBuffer(Target, Buffer));
+      return;
+   }
+
+   if (Skip(STATE_ARRAY_BUFFER, mArrayBuffer == Buffer))
+      return;
+
+   GLCALL(glBindBuffer(Target, Buffer));
+   mArrayBuffer = Buffer;
+}
+
+void CGlState::ActiveTexture(GLenum Unit)
+{
+   if (Skip(STATE_ACTIVE_TEXTURE, mActiveUnit == Unit))
+      return;
+
+   GLCALL(glActiveTexture(Unit));
+   mActiveUnit = Unit;
+}
+
+void CGlState::BindTexture(GLenum Target, GLuint Texture)
+{
+   unsigned int unit = mActiveUnit - GL_TEXTURE0;
+
+   // only 2D textures on tracked units, and only once the active unit is known
+   if (Target != GL_TEXTURE_2D || unit >= GL_STATE_TEXTURE_UNITS || !mKnown[STATE_ACTIVE_TEXTURE])
+   {
+      GLCALL(glBindTexture(Target, Texture));
+      return;
+   }
+
+   if (Skip(STATE_TEXTURE + unit, mTextures[unit] == Texture))
+      return;
+
+   GLCALL(glBindTexture(Target, Texture));
+   mTextures[unit] = Texture;
+}
+
+void CGlState::LineWidth(float Width)
+{
+   if (Skip(STATE_LINE_WIDTH, mLineWidth == Width))
+      return;
+
+   GLCALL(glLineWidth(Width));
+   mLineWidth = Width;
+}
+
+void CGlState::Enable(GLenum Cap)
+{
+   int state = CapState(Cap);
+
+   if (state >= 0 && Skip(state, mCaps[state - STATE_BLEND]))
+      return;
+
+   GLCALL(glEnable(Cap));
+
+   if (state >= 0)
+      mCaps[state - STATE_BLEND] = true;
+}
+
+void CGlState::Disable(GLenum Cap)
+{
+   int state = CapState(Cap);
+
+   if (state >= 0 && Skip(state, !mCaps[state - STATE_BLEND]))
+      return;
+
+   GLCALL(glDisable(Cap));
+
+   if (state >= 0)
+      mCaps[state - STATE_BLEND] = false;
+}
+
+void CGlState::StencilFunc(GLenum Func, GLint Ref, GLuint Mask)
+{
+   if (Skip(STATE_STENCIL_FUNC, mStencilFunc == Func && mStencilRef == Ref && mStencilFuncMask == Mask))
+      return;
+
+   GLCALL(glStencilFunc(Func, Ref, Mask));
+   mStencilFunc = Func;
+   mStencilRef = Ref;
+   mStencilFuncMask = Mask;
+}
+
+void CGlState::StencilOp(GLenum StencilFail, GLenum DepthFail, GLenum DepthPass)
+{
+   if (Skip(STATE_STENCIL_OP, mStencilOp[0] == StencilFail && mStencilOp[1] == DepthFail && mStencilOp[2] == DepthPass))
+      return;
+
+   GLCALL(glStencilOp(StencilFail, DepthFail, DepthPass));
+   mStencilOp[0] = StencilFail;
+   mStencilOp[1] = DepthFail;
+   mStencilOp[2] = DepthPass;
+}
+
+void CGlState::StencilMask(GLuint Mask)
+{
+   if (Skip(STATE_STENCIL_MASK, mStencilMask == Mask))
+      return;
+
+   GLCALL(glStencilMask(Mask));
+   mStencilMask = Mask;
+}
+
+void CGlState::ColorMask(GLboolean Red, GLboolean Green, GLboolean Blue, GLboolean Alpha)
+{
+   if (Skip(STATE_COLOR_MASK, mColorMask[0] == Red && mColorMask[1] == Green && mColorMask[2] == Blue && mColorMask[3] == Alpha))
+      return;
+
+   GLCALL(glColorMask(Red, Green, Blue, Alpha));
+   mColorMask[0] = Red;
+   mColorMask[1] = Green;
+   mColorMask[2] = Blue;
+   mColorMask[3] = Alpha;
+}
+
+void CGlState::DepthMask(GLboolean Flag)
+{
+   if (Skip(STATE_DEPTH_MASK, mDepthMask == Flag))
+      return;
+
+   GLCALL(glDepthMask(Flag));
+   mDepthMask = Flag;
+}
+
+void CGlState::Scissor(GLint X, GLint Y, GLsizei Width, GLsizei Height)
+{
+   if (Skip(STATE_SCISSOR_BOX, mScissorBox[0] == X && mScissorBox[1] == Y && mScissorBox[2] == Width && mScissorBox[3] == Height))
+      return;
+
+   GLCALL(glScissor(X, Y, Width, Height));
+   mScissorBox[0] = X;
+   mScissorBox[1] = Y;
+   mScissorBox[2] = Width;
+   mScissorBox[3] = Height;
+}
+
+void CGlState::BindFramebuffer(GLuint Framebuffer)
+{
+   if (Skip(STATE_FRAMEBUFFER, mFramebuffer == Framebuffer))
+      return;
+
+   GLCALL(glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer));
+   mFramebuffer = Framebuffer;
+}
+
+void CGlState::BlendFuncSeparate(GLenum SrcRgb, GLenum DstRgb, GLenum SrcAlpha, GLenum DstAlpha)
+{
+   if (Skip(STATE_BLEND_FUNC, mBlendFunc[0] == SrcRgb && mBlendFunc[1] == DstRgb && mBlendFunc[2] == SrcAlpha && mBlendFunc[3] == DstAlpha))
+      return;
+
+   GLCALL(glBlendFuncSeparate(SrcRgb, DstRgb, SrcAlpha, DstAlpha));
+   mBlendFunc[0] = SrcRgb;
+   mBlendFunc[1] = DstRgb;
+   mBlendFunc[2] = SrcAlpha;
+   mBlendFunc[3] = DstAlpha;
+}
+
+void CGlState::DeleteVertexArray(GLuint& Vao)
+{
+   if (Vao == 0)
+      return;
+
+   GLCALL(glDeleteVertexArrays(1, &Vao));
+
+   if (mVao == Vao)
+      mVao = 0;
+
+   Vao = 0;
+}
+
+void CGlState::DeleteBuffer(GLuint& Buffer)
+{
+   if (Buffer == 0)
+      return;
+
+   GLCALL(glDeleteBuffers(1, &Buffer));
+
+   if (mArrayBuffer == Buffer)
+      mArrayBuffer = 0;
+
+   Buffer = 0;
+}
+
+void CGlState::DeleteTexture(GLuint& Texture)
+{
+   if (Texture == 0)
+      return;
+
+   GLCALL(glDeleteTextures(1, &Texture));
+
+   for (int i = 0; i < GL_STATE_TEXTURE_UNITS; i++)
+   {
+      if (mTextures[i] == Texture)
+         mTextures[i] = 0;
+   }
+
+   Texture = 0;
+}
+
+void CGlState::DeleteFramebuffer(GLuint& Framebuffer)
+{
+   if (Framebuffer == 0)
+      return;
+
+   GLCALL(glDeleteFramebuffers(1, &Framebuffer));
+
+   if (mFramebuffer == Framebuffer)
+      mFramebuffer = 0;
+
+   Framebuffer = 0;
+}
+
+unsigned int CGlState::EndFrame()
+{
+   unsigned int avoided = mCallsAvoided;
+
+   mCallsAvoided = 0;
+
+   return avoided;
+}
@@ -0,0 +1,133 @@
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      GlState
+//! Class:      CPP Header
+//! Filename:   GlState.h
+//! Author:     Brian Woodard
+//! Purpose:    Tracks bound GL state so redundant binds can be skipped.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "CShaderUtils.h"
+
+const int GL_STATE_TEXTURE_UNITS = 16;
+
+// All renderers go through CGlState for program, VAO, buffer, texture, line
+// width and stencil/mask state, so a bind is only sent to the driver when it
+// changes something. Anything bound with raw GL calls will desync the cache.
+class CGlState
+{
+public:
+
+   static void UseProgram(GLuint Program);
+   static void BindVertexArray(GLuint Vao);
+   static void BindBuffer(GLenum Target, GLuint Buffer);
+   static void ActiveTexture(GLenum Unit);
+   static void BindTexture(GLenum Target, GLuint Texture);
+   static void LineWidth(float Width);
+   static void Enable(GLenum Cap);
+   static void Disable(GLenum Cap);
+   static void StencilFunc(GLenum Func, GLint Ref, GLuint Mask);
+   static void StencilOp(GLenum StencilFail, GLenum DepthFail, GLenum DepthPass);
+   static void StencilMask(GLuint Mask);
+   static void ColorMask(GLboolean Red, GLboolean Green, GLboolean Blue, GLboolean Alpha);
+   static void DepthMask(GLboolean Flag);
+   static void Scissor(GLint X, GLint Y, GLsizei Width, GLsizei Height);
+   static void BindFramebuffer(GLuint Framebuffer);
+   static void BlendFunc(GLenum Src, GLenum Dst) { BlendFuncSeparate(Src, Dst, Src, Dst); }
+   static void BlendFuncSeparate(GLenum SrcRgb, GLenum DstRgb, GLenum SrcAlpha, GLenum DstAlpha);
+
+   // deleting a bound object rebinds 0, these keep the cache in step
+   static void DeleteVertexArray(GLuint& Vao);
+   static void DeleteBuffer(GLuint& Buffer);
+   static void DeleteTexture(GLuint& Texture);
+   static void DeleteFramebuffer(GLuint& Framebuffer);
+
+   // forget everything, e.g. after a context change or third party GL code
+   static void Invalidate();
+
+   static float GetLineWidth() { return mLineWidth; }
+
+   // returns the number of calls avoided since the last call and resets it
+   static unsigned int EndFrame();
+
+private:
+
+   enum eState
+   {
+      STATE_PROGRAM,
+      STATE_VAO,
+      STATE_ARRAY_BUFFER,
+      STATE_ACTIVE_TEXTURE,
+      STATE_LINE_WIDTH,
+      STATE_BLEND,
+      STATE_STENCIL_TEST,
+      STATE_DEPTH_TEST,
+      STATE_SCISSOR_TEST,
+      STATE_STENCIL_FUNC,
+      STATE_STENCIL_OP,
+      STATE_STENCIL_MASK,
+      STATE_COLOR_MASK,
+      STATE_DEPTH_MASK,
+      STATE_SCISSOR_BOX,
+      STATE_FRAMEBUFFER,
+      STATE_BLEND_FUNC,
+      STATE_TEXTURE,
+
+      STATE_COUNT = STATE_TEXTURE + GL_STATE_TEXTURE_UNITS
+   };
+
+   static bool Skip(int State, bool Current);
+   static int CapState(GLenum Cap);
+
+   static bool         mKnown[STATE_COUNT];
+   static GLuint       mProgram;
+   static GLuint       mVao;
+   static GLuint       mArrayBuffer;
+   static GLenum       mActiveUnit;
+   static GLuint       mTextures[GL_STATE_TEXTURE_UNITS];
+   static float        mLineWidth;
+   static bool         mCaps[STATE_SCISSOR_TEST - STATE_BLEND + 1];
+   static GLenum       mStencilFunc;
+   static GLint        mStencilRef;
+   static GLuint       mStencilFuncMask;
+   static GLenum       mStencilOp[3];
+   static GLuint       mStencilMask;
+   static GLboolean    mColorMask[4];
+   static GLboolean    mDepthMask;
+   static GLint        mScissorBox[4];
+   static GLuint       mFramebuffer;
+   static GLenum       mBlendFunc[4];
+   static unsigned int mCallsAvoided;
+
+};
@@ -43,6 +43,10 @@
 #include "IresMenu.h"
 #include "IresTypes.h"
 #include "PrintData.h"
+#include "GlState.h"
+
+CShader* CIresMenu::mBlitShader = nullptr;
+GLuint   CIresMenu::mBlitVao = 0;
 
 const char* OffOnStr[] =
 {
@@ -183,26 +187,46 @@ const char* Ld1_57ModeStr[] =
 
 CIresMenu::CIresMenu(glm::mat4& Projection)
    : mConfig{},
+     mConfigApplied(false),
      mCursor{},
      mMenuStack(),
      mLine(),
-     mBackground(),
+     mGeometry(Projection),
+     mBackgroundQuad(-1),
+     mBackgroundBorder(-1),
+     mMenuQuads(),
+     mMenuBorders(),
+     mGeometryDirty(true),
+     mLayoutDirty(true),
+     mCacheFbo(0),
+     mCacheTexture(0),
+     mCacheStencil(0),
+     mCacheWidth(0),
+     mCacheHeight(0),
+     mCacheDirty(true),
+     mCacheFailed(false),
+     mFontGeneration(0),
      mText(nullptr),
      mBoldText(nullptr),
      mProjection(Projection),
      mTextColor(1.0f),
      mLineColor(1.0f),
      mBackgroundColor(1.0f),
-     mClipEnabled(false)
+     mClipEnabled(false),
+     mMtiSettings{false, MTI_COLOR_GREEN, MTI_COLOR_GREEN, true, -1, -1.0f, 0}
 {
    mMenuStack.reserve(5);
    mLine.setMVP(Projection);
    mPolygon.setMVP(Projection);
-   mBackground.setMVP(Projection);
+
+   mBackgroundQuad = mGeometry.Add(TRIANGLE);
+   mBackgroundBorder = mGeometry.Add(SOLID);
 }
 
 CIresMenu::~CIresMenu()
 {
+   DeleteMenuCache();
+
    if (mText)
    {
       delete mText;
@@ -218,48 +242,242 @@ void CIresMenu::Draw()
 {
    if (mConfig.MenuActive)
    {
-      if (mClipEnabled)
+      // widths measured while the menu font was still loading used a fallback
+      if (mFontGeneration != CText::GetFontGeneration())
       {
-         // clip menu area by drawing a stencil object around the whole area
-         GLCALL(glClear(GL_STENCIL_BUFFER_BIT));
-         GLCALL(glEnable(GL_STENCIL_TEST));
-
-         GLCALL(glStencilFunc(GL_ALWAYS, 1, 0xFF));
-         GLCALL(glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE));
-         GLCALL(glStencilMask(0xFF));
-         GLCALL(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
-         GLCALL(glDepthMask(GL_FALSE));
-
-         // draw stencil objects
-         DrawBackground(true);
-
-         GLCALL(glStencilFunc(GL_EQUAL, 1, 0xFF));
-         GLCALL(glStencilMask(~0));
-         GLCALL(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
-         GLCALL(glDepthMask(GL_TRUE));
+         mFontGeneration = CText::GetFontGeneration();
+         BuildWidthCache();
+         LayoutMenus();
+         mGeometryDirty = true;
+         mCacheDirty = true;
       }
 
-      DrawBackground();
+      if (mLayoutDirty)
+         LayoutMenus();
 
-      if (mText)
+      if (mGeometryDirty)
+         UpdateGeometry();
+
+      // the menus only change when a PDU arrives, so they are drawn into the
+      // cache then and every frame just composites the cache
+      if (!mCacheFailed && (mCacheDirty || !mCacheFbo))
+         RenderMenuCache();
+
+      if (mCacheFbo)
+         DrawMenuCache();
+      else
+         DrawMenus();
+
+      // the cursor is an overlay so moving it leaves the cache alone
+      if (mText && mMenuStack.size())
       {
-         // loop over stack of menus and draw each one
-         for (size_t i = 0; i < mMenuStack.size(); i++)
-         {
-            float font_size = (float)mText->GetFontSize();
-            glm::vec3 start = mMenuStack[i].Position;
+         DrawMenuOps(mMenuStack.back(), mMenuStack.back().CursorOps);
+         CLine::Flush();
+         CText::Flush();
+      }
+   }
+}
+
+void CIresMenu::Close()
+{
+   if (!mConfig.MenuActive)
+      return;
 
-            start.x += font_size * 2.0f; // TODO: Use advance instead of size? Monospace font?
-            start.y += font_size;
+   TIresMenuConfigPdu config = mConfig;
 
-            DrawMenuBorder(&mMenuStack[i]);
-            DrawMenuItems(mMenuStack[i].Items, start, mMenuStack[i].Size.x, (i == mMenuStack.size()-1));
-         }
+   config.MenuActive = 0;
+   printf("Menu: Inactive (host timed out)\n");
+
+   ApplyConfig(config);
+}
+
+void CIresMenu::Resize(int Width, int Height)
+{
+   if (Width == mCacheWidth && Height == mCacheHeight)
+      return;
+
+   // same top-left origin as the projection the menu was created with
+   mProjection = glm::ortho(0.0f, (float)Width, (float)Height, 0.0f);
+
+   mLine.setMVP(mProjection);
+   mPolygon.setMVP(mProjection);
+   mGeometry.SetProjection(mProjection);
+
+   if (mText)
+      mText->SetMVP(mProjection);
+
+   if (mBoldText)
+      mBoldText->SetMVP(mProjection);
+
+   mLayoutDirty = true;
+   mGeometryDirty = true;
+
+   DeleteMenuCache();
+
+   mCacheWidth = Width;
+   mCacheHeight = Height;
+   mCacheDirty = true;
+   mCacheFailed = false;
+}
+
+void CIresMenu::DrawMenus()
+{
+   if (mClipEnabled)
+   {
+      // anything queued before the menu must not be clipped by it
+      CLine::Flush();
+      CText::Flush();
+
+      // clip menu area by drawing a stencil object around the whole area
+      GLCALL(glClear(GL_STENCIL_BUFFER_BIT));
+      CGlState::Enable(GL_STENCIL_TEST);
+
+      CGlState::StencilFunc(GL_ALWAYS, 1, 0xFF);
+      CGlState::StencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+      CGlState::StencilMask(0xFF);
+      CGlState::ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+      CGlState::DepthMask(GL_FALSE);
+
+      // draw stencil objects
+      DrawBackground(true);
+      CLine::Flush();
+
+      CGlState::StencilFunc(GL_EQUAL, 1, 0xFF);
+      CGlState::StencilMask(~0);
+      CGlState::ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+      CGlState::DepthMask(GL_TRUE);
+   }
+
+   DrawBackground();
+
+   if (mText)
+   {
+      // loop over stack of menus and draw each one
+      for (size_t i = 0; i < mMenuStack.size(); i++)
+      {
+         DrawMenuBorder(i);
+         DrawMenuOps(mMenuStack[i], mMenuStack[i].Ops);
+
+         // geometry and text are queued, draw them before the next menu in the
+         // stack covers this one
+         CLine::Flush();
+         CText::Flush();
       }
+   }
+
+   CLine::Flush();
+
+   if (mClipEnabled)
+      CGlState::Disable(GL_STENCIL_TEST);
+}
+
+bool CIresMenu::CreateMenuCache()
+{
+   GLenum status;
+
+   if (mCacheWidth <= 0 || mCacheHeight <= 0)
+   {
+      GLint viewport[4] = {};
+
+      GLCALL(glGetIntegerv(GL_VIEWPORT, viewport));
+      mCacheWidth = viewport[2];
+      mCacheHeight = viewport[3];
+   }
+
+   GLCALL(glGenTextures(1, &mCacheTexture));
+   CGlState::BindTexture(GL_TEXTURE_2D, mCacheTexture);
+   GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mCacheWidth, mCacheHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST)); // drawn 1:1 with the window
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+   GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+   // the clip to the menu background uses the stencil buffer
+   GLCALL(glGenRenderbuffers(1, &mCacheStencil));
+   GLCALL(glBindRenderbuffer(GL_RENDERBUFFER, mCacheStencil));
+   GLCALL(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, mCacheWidth, mCacheHeight));
+
+   GLCALL(glGenFramebuffers(1, &mCacheFbo));
+   CGlState::BindFramebuffer(mCacheFbo);
+   GLCALL(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mCacheTexture, 0));
+   GLCALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mCacheStencil));
+
+   status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+   CGlState::BindFramebuffer(0);
+
+   if (status != GL_FRAMEBUFFER_COMPLETE)
+   {
+      printf("Menu: render cache incomplete (0x%x), drawing menus directly\n", status);
+      DeleteMenuCache();
+      return false;
+   }
+
+   return true;
+}
+
+void CIresMenu::DeleteMenuCache()
+{
+   CGlState::DeleteFramebuffer(mCacheFbo);
+   CGlState::DeleteTexture(mCacheTexture);
+
+   if (mCacheStencil)
+   {
+      GLCALL(glDeleteRenderbuffers(1, &mCacheStencil));
+      mCacheStencil = 0;
+   }
+}
+
+void CIresMenu::RenderMenuCache()
+{
+   const GLfloat clear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+   if (!mCacheFbo && !CreateMenuCache())
+   {
+      mCacheFailed = true;
+      return;
+   }
+
+   // anything queued so far belongs to the window
+   CLine::Flush();
+   CText::Flush();
+
+   CGlState::BindFramebuffer(mCacheFbo);
+   GLCALL(glClearBufferfv(GL_COLOR, 0, clear));
+
+   // keep the cache premultiplied so compositing it matches drawing the
+   // menus straight into the window
+   CGlState::BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+   DrawMenus();
+
+   CGlState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+   CGlState::BindFramebuffer(0);
+
+   mCacheDirty = false;
+}
 
-      if (mClipEnabled)
-         glDisable(GL_STENCIL_TEST);
+void CIresMenu::DrawMenuCache()
+{
+   if (!mBlitShader)
+   {
+      mBlitShader = new CShader("blit.vs", "blit.fs");
+      GLCALL(glGenVertexArrays(1, &mBlitVao)); // core profile needs one bound, the quad has no attributes
    }
+
+   // keep anything queued underneath the menus
+   CLine::Flush();
+   CText::Flush();
+
+   mBlitShader->use();
+   mBlitShader->setInt("textureUnit", 0);
+
+   CGlState::ActiveTexture(GL_TEXTURE0);
+   CGlState::BindTexture(GL_TEXTURE_2D, mCacheTexture);
+   CGlState::BindVertexArray(mBlitVao);
+
+   CGlState::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+   GLCALL(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+   CGlState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 float CIresMenu::DrawActionItem(const TIresMenuItem& Item, float X, float Y, float Width,  float FontSize, bool Bold)
@@ -293,7 +511,7 @@ float CIresMenu::DrawActionItem(const TIresMenuItem& Item, float X, float Y, flo
 
       if (mode_and_alarm[1] != ALARM_UNKNOWN)
       {
-         float str_width = mText->GetWidth(IresAlarmStr[mode_and_alarm[1]]);
+         float str_width = GetStringWidth(IresAlarmStr[mode_and_alarm[1]]);
          mText->Print(IresAlarmStr[mode_and_alarm[1]], Width - 200.0f - str_width, Y);
       }
 
@@ -338,7 +556,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(OffOnStr))
             temp = ArrayCount(OffOnStr)-1;
 
-         sel_width = mText->GetWidth(OffOnStr[temp]);
+         sel_width = GetStringWidth(OffOnStr[temp]);
          mText->Print(OffOnStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -350,7 +568,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(EZoomStr))
             temp = ArrayCount(EZoomStr)-1;
 
-         sel_width = mText->GetWidth(EZoomStr[temp]);
+         sel_width = GetStringWidth(EZoomStr[temp]);
          mText->Print(EZoomStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -374,7 +592,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(SceneSetupStr))
             temp = ArrayCount(SceneSetupStr)-1;
 
-         sel_width = mText->GetWidth(SceneSetupStr[temp]);
+         sel_width = GetStringWidth(SceneSetupStr[temp]);
          mText->Print(SceneSetupStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -386,7 +604,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(GateSizeStr))
             temp = ArrayCount(GateSizeStr)-1;
 
-         sel_width = mText->GetWidth(GateSizeStr[temp]);
+         sel_width = GetStringWidth(GateSizeStr[temp]);
          mText->Print(GateSizeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -398,7 +616,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(CameraExtenderStr))
             temp = ArrayCount(CameraExtenderStr)-1;
 
-         sel_width = mText->GetWidth(CameraExtenderStr[temp]);
+         sel_width = GetStringWidth(CameraExtenderStr[temp]);
          mText->Print(CameraExtenderStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -409,7 +627,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(CalibrationTypeStr))
             temp = ArrayCount(CalibrationTypeStr)-1;
 
-         sel_width = mText->GetWidth(CalibrationTypeStr[temp]);
+         sel_width = GetStringWidth(CalibrationTypeStr[temp]);
          mText->Print(CalibrationTypeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -420,7 +638,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(PolarityStr))
             temp = ArrayCount(PolarityStr)-1;
 
-         sel_width = mText->GetWidth(PolarityStr[temp]);
+         sel_width = GetStringWidth(PolarityStr[temp]);
          mText->Print(PolarityStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -431,7 +649,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(PseudoColorStr))
             temp = ArrayCount(PseudoColorStr)-1;
 
-         sel_width = mText->GetWidth(PseudoColorStr[temp]);
+         sel_width = GetStringWidth(PseudoColorStr[temp]);
          mText->Print(PseudoColorStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -442,7 +660,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(DesiredModeStr))
             temp = ArrayCount(DesiredModeStr)-1;
 
-         sel_width = mText->GetWidth(DesiredModeStr[temp]);
+         sel_width = GetStringWidth(DesiredModeStr[temp]);
          mText->Print(DesiredModeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -454,7 +672,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(LaserTargetStr))
             temp = ArrayCount(LaserTargetStr)-1;
 
-         sel_width = mText->GetWidth(LaserTargetStr[temp]);
+         sel_width = GetStringWidth(LaserTargetStr[temp]);
          mText->Print(LaserTargetStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -480,7 +698,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > AVT_ALG_COUNT)
             temp = AVT_ALG_COUNT-1;
 
-         sel_width = mText->GetWidth(AvtAlgorithmStr[temp]);
+         sel_width = GetStringWidth(AvtAlgorithmStr[temp]);
          mText->Print(AvtAlgorithmStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -491,7 +709,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > AVT_GATE_TYPE_COUNT)
             temp = AVT_GATE_TYPE_COUNT-1;
 
-         sel_width = mText->GetWidth(AvtGateTypeStr[temp]);
+         sel_width = GetStringWidth(AvtGateTypeStr[temp]);
          mText->Print(AvtGateTypeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -502,7 +720,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > AVT_GATE_SIZE_COUNT)
             temp = AVT_GATE_SIZE_COUNT-1;
 
-         sel_width = mText->GetWidth(AvtGateSizeStr[temp]);
+         sel_width = GetStringWidth(AvtGateSizeStr[temp]);
          mText->Print(AvtGateSizeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -531,7 +749,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(MtiModeStr))
             temp = ArrayCount(MtiModeStr)-1;
 
-         sel_width = mText->GetWidth(MtiModeStr[temp]);
+         sel_width = GetStringWidth(MtiModeStr[temp]);
          mText->Print(MtiModeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -543,7 +761,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > MTI_COLOR_COUNT)
             temp = MTI_COLOR_COUNT-1;
 
-         sel_width = mText->GetWidth(MtiBoxColorStr[temp]);
+         sel_width = GetStringWidth(MtiBoxColorStr[temp]);
          mText->Print(MtiBoxColorStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -554,7 +772,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ILLUM_MODE_COUNT-1)
             temp = ILLUM_MODE_COUNT-1;
 
-         sel_width = mText->GetWidth(IllumModeStr[temp]);
+         sel_width = GetStringWidth(IllumModeStr[temp]);
          mText->Print(IllumModeStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -579,7 +797,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(DisableEnableStr))
             temp = ArrayCount(DisableEnableStr)-1;
 
-         sel_width = mText->GetWidth(DisableEnableStr[temp]);
+         sel_width = GetStringWidth(DisableEnableStr[temp]);
          mText->Print(DisableEnableStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -591,7 +809,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > ArrayCount(ManAutoStr))
             temp = ArrayCount(ManAutoStr)-1;
 
-         sel_width = mText->GetWidth(ManAutoStr[temp]);
+         sel_width = GetStringWidth(ManAutoStr[temp]);
          mText->Print(ManAutoStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -613,7 +831,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > FUSE_COMBO_COUNT-1)
             temp = FUSE_COMBO_COUNT-1;
 
-         sel_width = mText->GetWidth(FusionCombinationStr[temp]);
+         sel_width = GetStringWidth(FusionCombinationStr[temp]);
          mText->Print(FusionCombinationStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -624,7 +842,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > SEESPOT_COMBO_COUNT-1)
             temp = SEESPOT_COMBO_COUNT-1;
 
-         sel_width = mText->GetWidth(SeeSpotCombinationStr[temp]);
+         sel_width = GetStringWidth(SeeSpotCombinationStr[temp]);
          mText->Print(SeeSpotCombinationStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -635,7 +853,7 @@ float CIresMenu::DrawSelectionItem(const TIresMenuItem& Item, float X, float Y,
          if (temp > SEESPOT_COLOR_COUNT-1)
             temp = SEESPOT_COLOR_COUNT-1;
 
-         sel_width = mText->GetWidth(SeeSpotColorStr[temp]);
+         sel_width = GetStringWidth(SeeSpotColorStr[temp]);
          mText->Print(SeeSpotColorStr[temp], Width - 200.0f - sel_width, Y);
          break;
       }
@@ -687,7 +905,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (mode > MODE_UNKNOWN)
             mode = MODE_UNKNOWN;
 
-         float str_width = mText->GetWidth(IresModeStr[mode]);
+         float str_width = GetStringWidth(IresModeStr[mode]);
          mText->Print(IresModeStr[mode], Width - 200.0f - str_width, Y);
          break;
       }
@@ -704,7 +922,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (alarm > ALARM_UNKNOWN)
             alarm = ALARM_UNKNOWN;
 
-         float str_width = mText->GetWidth(IresAlarmStr[alarm]);
+         float str_width = GetStringWidth(IresAlarmStr[alarm]);
          mText->Print(IresAlarmStr[alarm], Width - 200.0f - str_width, Y);
          break;
       }
@@ -813,7 +1031,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ArrayCount(TempStatusStr))
             temp = ArrayCount(TempStatusStr)-1;
 
-         float str_width = mText->GetWidth(TempStatusStr[temp]);
+         float str_width = GetStringWidth(TempStatusStr[temp]);
          mText->Print(TempStatusStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -824,7 +1042,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ArrayCount(ManAutoStr))
             temp = ArrayCount(ManAutoStr)-1;
 
-         float str_width = mText->GetWidth(ManAutoStr[temp]);
+         float str_width = GetStringWidth(ManAutoStr[temp]);
          mText->Print(ManAutoStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -835,7 +1053,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ArrayCount(RfLaserStateStr))
             temp = ArrayCount(RfLaserStateStr)-1;
 
-         float str_width = mText->GetWidth(RfLaserStateStr[temp]);
+         float str_width = GetStringWidth(RfLaserStateStr[temp]);
          mText->Print(RfLaserStateStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -847,7 +1065,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ArrayCount(FalseTrueStr))
             temp = ArrayCount(FalseTrueStr)-1;
 
-         float str_width = mText->GetWidth(FalseTrueStr[temp]);
+         float str_width = GetStringWidth(FalseTrueStr[temp]);
          mText->Print(FalseTrueStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -869,7 +1087,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > AVT_TRACK_COUNT)
             temp = AVT_TRACK_COUNT-1;
 
-         float str_width = mText->GetWidth(AvtTrackingStatusStr[temp]);
+         float str_width = GetStringWidth(AvtTrackingStatusStr[temp]);
          mText->Print(AvtTrackingStatusStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -880,7 +1098,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ILLUM_COUNT)
             temp = ILLUM_COUNT-1;
 
-         float str_width = mText->GetWidth(IllumStateStr[temp]);
+         float str_width = GetStringWidth(IllumStateStr[temp]);
          mText->Print(IllumStateStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -891,7 +1109,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ArrayCount(LdPositionStr))
             temp = ArrayCount(LdPositionStr)-1;
 
-         float str_width = mText->GetWidth(LdPositionStr[temp]);
+         float str_width = GetStringWidth(LdPositionStr[temp]);
          mText->Print(LdPositionStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -902,7 +1120,7 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
          if (temp > ArrayCount(Ld1_57ModeStr))
             temp = ArrayCount(Ld1_57ModeStr)-1;
 
-         float str_width = mText->GetWidth(Ld1_57ModeStr[temp]);
+         float str_width = GetStringWidth(Ld1_57ModeStr[temp]);
          mText->Print(Ld1_57ModeStr[temp], Width - 200.0f - str_width, Y);
          break;
       }
@@ -915,206 +1133,437 @@ float CIresMenu::DrawStatusItem(const TIresMenuItem& Item, float X, float Y, flo
 
 void CIresMenu::DrawBackground(bool BackgroundOnly)
 {
+   mGeometry.Draw(mBackgroundQuad);
+
+   if (!BackgroundOnly)
+      mGeometry.Draw(mBackgroundBorder);
+}
+
+void CIresMenu::DrawMenuBorder(size_t Index)
+{
+   TIresMenuData* menu = &mMenuStack[Index];
+
+   float font_size = (float)mText->GetFontSize();
+   float x = menu->Position.x + 3;
+   float y = menu->Position.y + font_size;
+
+   //printf("Menu: Draw %s\n", menu->Title);
+
+   mGeometry.Draw(mMenuQuads[Index]);
+   mGeometry.Draw(mMenuBorders[Index]);
+
+   mText->Print(menu->Title, x, y);
+}
+
+// rebuild the retained background and border shapes, only needed after a
+// config or menu PDU changes the layout
+void CIresMenu::UpdateGeometry()
+{
+   std::vector<glm::vec3> border;
+
    glm::vec3 p1 = glm::vec3(mConfig.X, mConfig.Y, 0.0f);
    glm::vec3 p2 = p1 + glm::vec3(mConfig.Width, 0.0f, 0.0f);
    glm::vec3 p3 = p1 + glm::vec3(mConfig.Width, mConfig.Height, 0.0f);
    glm::vec3 p4 = p1 + glm::vec3(0.0f,          mConfig.Height, 0.0f);
 
-   mBackground.DrawQuad((float)mConfig.X, (float)mConfig.Y, (float)mConfig.Width, (float)mConfig.Height);
+   mGeometry.SetQuad(mBackgroundQuad, (float)mConfig.X, (float)mConfig.Y, (float)mConfig.Width, (float)mConfig.Height);
+   mGeometry.SetColor(mBackgroundQuad, mBackgroundColor);
 
-   if (!BackgroundOnly)
+   border = { p1, p2, p2, p3, p3, p4, p4, p1 };
+   mGeometry.SetVertices(mBackgroundBorder, border);
+   mGeometry.SetColor(mBackgroundBorder, mLineColor);
+   mGeometry.SetLineWidth(mBackgroundBorder, mConfig.LineWidth);
+
+   float font_size = mText ? (float)mText->GetFontSize() : 0.0f;
+
+   for (size_t i = 0; i < mMenuStack.size(); i++)
    {
-      mLine.SetPosition(p1, p2);
-      mLine.Draw();
-      mLine.SetPosition(p2, p3);
-      mLine.Draw();
-      mLine.SetPosition(p3, p4);
-      mLine.Draw();
-      mLine.SetPosition(p4, p1);
-      mLine.Draw();
+      TIresMenuData* menu = &mMenuStack[i];
+
+      // shapes are kept per stack level and reused as menus are pushed and popped
+      if (i >= mMenuQuads.size())
+      {
+         mMenuQuads.push_back(mGeometry.Add(TRIANGLE));
+         mMenuBorders.push_back(mGeometry.Add(SOLID));
+      }
+
+      p1 = menu->Position;
+      p2 = p1 + glm::vec3(menu->Size.x, 0.0f, 0.0f);
+      p3 = p1 + glm::vec3(menu->Size.x, menu->Size.y, 0.0f);
+      p4 = p1 + glm::vec3(0.0f,         menu->Size.y, 0.0f);
+
+      mGeometry.SetQuad(mMenuQuads[i], menu->Position.x, menu->Position.y, menu->Size.x, menu->Size.y);
+      mGeometry.SetColor(mMenuQuads[i], mBackgroundColor);
+
+      // outline plus the line under the title
+      border = { p1, p2, p2, p3, p3, p4, p4, p1,
+                 p1 + glm::vec3(0.0f, font_size + 3, 0.0f),
+                 p2 + glm::vec3(0.0f, font_size + 3, 0.0f) };
+      mGeometry.SetVertices(mMenuBorders[i], border);
+      mGeometry.SetColor(mMenuBorders[i], mLineColor);
+      mGeometry.SetLineWidth(mMenuBorders[i], mConfig.LineWidth);
    }
+
+   mGeometryDirty = false;
 }
 
-void CIresMenu::DrawMenuBorder(TIresMenuData* Menu)
+// measure every constant string the menu can show once per font, right
+// alignment is then a lookup instead of walking the glyphs each frame
+void CIresMenu::BuildWidthCache()
 {
-   glm::vec3 p1 = Menu->Position;
-   glm::vec3 p2 = p1 + glm::vec3(Menu->Size.x, 0.0f, 0.0f);
-   glm::vec3 p3 = p1 + glm::vec3(Menu->Size.x, Menu->Size.y, 0.0f);
-   glm::vec3 p4 = p1 + glm::vec3(0.0f,         Menu->Size.y, 0.0f);
+   mStringWidths.clear();
+
+   if (!mText)
+      return;
+
+   AddWidths(IresMenuStr, MENU_COUNT);
+   AddWidths(IresAlarmStr, ALARM_COUNT);
+   AddWidths(IresModeStr, MODE_COUNT);
+
+   // the shared value tables carry a trailing "XXX" past the enum count
+   AddWidths(AvtTrackingStatusStr, AVT_TRACK_COUNT + 1);
+   AddWidths(AvtAlgorithmStr, AVT_ALG_COUNT + 1);
+   AddWidths(AvtGateTypeStr, AVT_GATE_TYPE_COUNT + 1);
+   AddWidths(AvtGateSizeStr, AVT_GATE_SIZE_COUNT + 1);
+   AddWidths(MtiBoxColorStr, MTI_COLOR_COUNT + 1);
+   AddWidths(IllumStateStr, ILLUM_COUNT + 1);
+   AddWidths(IllumModeStr, ILLUM_MODE_COUNT + 1);
+   AddWidths(FusionCombinationStr, FUSE_COMBO_COUNT + 1);
+   AddWidths(SeeSpotCombinationStr, SEESPOT_COMBO_COUNT + 1);
+   AddWidths(SeeSpotColorStr, SEESPOT_COLOR_COUNT + 1);
+
+   AddWidths(OffOnStr, ArrayCount(OffOnStr));
+   AddWidths(FalseTrueStr, ArrayCount(FalseTrueStr));
+   AddWidths(DisableEnableStr, ArrayCount(DisableEnableStr));
+   AddWidths(TempStatusStr, ArrayCount(TempStatusStr));
+   AddWidths(EZoomStr, ArrayCount(EZoomStr));
+   AddWidths(SceneSetupStr, ArrayCount(SceneSetupStr));
+   AddWidths(GateSizeStr, ArrayCount(GateSizeStr));
+   AddWidths(CameraExtenderStr, ArrayCount(CameraExtenderStr));
+   AddWidths(CalibrationTypeStr, ArrayCount(CalibrationTypeStr));
+   AddWidths(PolarityStr, ArrayCount(PolarityStr));
+   AddWidths(PseudoColorStr, ArrayCount(PseudoColorStr));
+   AddWidths(DesiredModeStr, ArrayCount(DesiredModeStr));
+   AddWidths(ManAutoStr, ArrayCount(ManAutoStr));
+   AddWidths(RfLaserStateStr, ArrayCount(RfLaserStateStr));
+   AddWidths(LaserTargetStr, ArrayCount(LaserTargetStr));
+   AddWidths(MtiModeStr, ArrayCount(MtiModeStr));
+   AddWidths(LdPositionStr, ArrayCount(LdPositionStr));
+   AddWidths(Ld1_57ModeStr, ArrayCount(Ld1_57ModeStr));
+}
 
-   float font_size = (float)mText->GetFontSize();
-   float x = Menu->Position.x + 3;
-   float y = Menu->Position.y + font_size;
+void CIresMenu::AddWidths(const char** Table, size_t Count)
+{
+   for (size_t i = 0; i < Count; i++)
+   {
+      if (Table[i])
+         mStringWidths[Table[i]] = mText->GetWidth(Table[i]);
+   }
+}
 
-   //printf("Menu: Draw %s\n", Menu->Title);
+// keyed by address, so only the constant tables hit, anything else is measured
+float CIresMenu::GetStringWidth(const char* Text)
+{
+   auto it = mStringWidths.find(Text);
 
-   mBackground.DrawQuad(Menu->Position.x, Menu->Position.y, Menu->Size.x, Menu->Size.y);
+   if (it != mStringWidths.end())
+      return it->second;
 
-   mLine.SetPosition(p1, p2);
-   mLine.Draw();
-   mLine.SetPosition(p2, p3);
-   mLine.Draw();
-   mLine.SetPosition(p3, p4);
-   mLine.Draw();
-   mLine.SetPosition(p4, p1);
-   mLine.Draw();
+   return mText->GetWidth(Text);
+}
 
-   // draw line under title
-   p1.y += font_size + 3;
-   p2.y += font_size + 3;
-   mLine.SetPosition(p1, p2);
-   mLine.Draw();
+// positions every item and the cursor of each menu in the stack, only needed
+// when a menu, item, cursor or config PDU changes something
+void CIresMenu::LayoutMenus()
+{
+   for (size_t i = 0; i < mMenuStack.size(); i++)
+      LayoutMenuItems(mMenuStack[i], (i == mMenuStack.size()-1));
 
-   mText->Print(Menu->Title, x, y);
+   mLayoutDirty = false;
 }
 
-void CIresMenu::DrawMenuItems(const std::vector<TIresMenuItem>& Items, glm::vec3 Start, float Width, bool Bottom)
+float CIresMenu::GetItemWidth(const TIresMenuItem& Item, bool Bold)
 {
-   float font_size = (float)mText->GetFontSize() + 3.0f;
-   float x = Start.x + 3.0f;
-   float y = Start.y + font_size * 2.0f;
+   if (Bold && mBoldText)
+      return mBoldText->GetWidth(IresMenuStr[Item.Id]);
+
+   return GetStringWidth(IresMenuStr[Item.Id]);
+}
+
+void CIresMenu::LayoutMenuItems(TIresMenuData& Menu, bool Bottom)
+{
+   const std::vector<TIresMenuItem>& items = Menu.Items;
+   float font_size;
+   float x;
+   float y;
    float bot_width = 0.0f;
    bool  first_bottom = true;
 
+   Menu.Ops.clear();
+   Menu.CursorOps.clear();
+
+   if (!mText)
+      return;
+
+   font_size = (float)mText->GetFontSize();
+   x = Menu.Position.x + font_size * 2.0f + 3.0f; // TODO: Use advance instead of size? Monospace font?
+   y = Menu.Position.y + font_size;
+   font_size += 3.0f;
+   y += font_size * 2.0f;
+
    // do an initial pass to get the width of the bottom action items
-   for (size_t i  = 0; i < Items.size(); i++)
+   for (size_t i  = 0; i < items.size(); i++)
    {
-      if (Items[i].Type == FIELD_ACTION_BOT)
-         bot_width += mText->GetWidth(IresMenuStr[Items[i].Id]) + font_size * 3.0f;
+      if (items[i].Type == FIELD_ACTION_BOT)
+         bot_width += GetStringWidth(IresMenuStr[items[i].Id]) + font_size * 3.0f;
    }
 
-   for (size_t i = 0; i < Items.size(); i++)
+   for (size_t i = 0; i < items.size(); i++)
    {
       float width = 0;
+      bool  bold = (i == mCursor.CursorLocation && mCursor.CursorType == CURSOR_BOLD);
+      int   indent_level = items[i].Appearance & 0x7;
+      float indent = font_size * indent_level;
 
       // only draw bottom menu items on last menu in stack
-      if (Items[i].Type == FIELD_ACTION_BOT && Bottom)
+      if (items[i].Type == FIELD_ACTION_BOT && Bottom)
       {
-         // draw action item at bottom of menu
-         bool  bold = (i == mCursor.CursorLocation && mCursor.CursorType == CURSOR_BOLD);
-
          if (first_bottom)
          {
             y = mConfig.Height + 3.0f;
             x = mConfig.X + mConfig.Width - bot_width; // right-align bottom action items
             first_bottom = false;
          }
-         
-         width = DrawActionItem(Items[i], x, y, Width, font_size, bold);
+
+         width = GetItemWidth(items[i], bold);
+         Menu.Ops.push_back({MENU_OP_ITEM, i, glm::vec3(x, y, 0.0f), 0.0f, bold});
 
          x += width + font_size * 3.0f;
       }
       else
       {
-         bool  bold = (i == mCursor.CursorLocation && mCursor.CursorType == CURSOR_BOLD);
-         int   indent_level = Items[i].Appearance & 0x7;
-         float indent = font_size * indent_level;
-
-         switch (Items[i].Type)
+         switch (items[i].Type)
          {
             case FIELD_ACTION:
-               width = DrawActionItem(Items[i], x + indent, y, Width, font_size, bold);
-               break;
             case FIELD_STATUS:
-               width = DrawStatusItem(Items[i], x + indent, y, Width, font_size, bold);
-               break;
             case FIELD_SINGLE_SELECTION:
             case FIELD_LIST_SELECTION:
             case FIELD_RANGE_SELECTION:
-               width = DrawSelectionItem(Items[i], x + indent, y, Width, font_size, bold);
+               width = GetItemWidth(items[i], bold);
+               Menu.Ops.push_back({MENU_OP_ITEM, i, glm::vec3(x + indent, y, 0.0f), 0.0f, bold});
                break;
             case FIELD_LINE:
-            {
-               glm::vec3 start = glm::vec3(Start.x + 5.0f - font_size * 2.0f, y, 0.0f);
-               glm::vec3 end = start;
+               Menu.Ops.push_back({MENU_OP_LINE, i, glm::vec3(Menu.Position.x - 1.0f, y, 0.0f), Menu.Size.x, false});
+               break;
+            default:
+               break;
+         }
 
-               end.x += Width;
+         y += font_size;
+      }
 
-               mLine.SetPosition(start, end);
-               mLine.Draw();
+      if (Bottom && i == mCursor.CursorLocation)
+      {
+         glm::vec3 cursor;
+
+         if (items[i].Type == FIELD_ACTION_BOT)
+            cursor = glm::vec3(x - font_size - 4.0f - (width + font_size * 3.0f), y, 0.0f);
+         else
+            cursor = glm::vec3(x - font_size - 4.0f, y - font_size, 0.0f);
+
+         switch (mCursor.CursorType)
+         {
+            case CURSOR_CARAT:
+               Menu.CursorOps.push_back({MENU_OP_CARAT, i, cursor, 0.0f, false});
+               break;
+            case CURSOR_DIAMOND:
+               Menu.CursorOps.push_back({MENU_OP_DIAMOND, i, cursor, 0.0f, false});
+               break;
+            case CURSOR_HIGHLIGHT:
+               cursor.x += (font_size + 4.0f) + indent;
+               Menu.CursorOps.push_back({MENU_OP_HIGHLIGHT, i, cursor, (width + font_size * 4.25f) - font_size*3, false});
+               break;
+            case CURSOR_BOLD:
+               // done above
                break;
-            }
             default:
                break;
          }
+      }
+   }
+}
 
-         y += font_size;
+float CIresMenu::DrawItem(const TIresMenuItem& Item, float X, float Y, float Width, float FontSize, bool Bold)
+{
+   switch (Item.Type)
+   {
+      case FIELD_ACTION:
+      case FIELD_ACTION_BOT:
+         return DrawActionItem(Item, X, Y, Width, FontSize, Bold);
+      case FIELD_STATUS:
+         return DrawStatusItem(Item, X, Y, Width, FontSize, Bold);
+      case FIELD_SINGLE_SELECTION:
+      case FIELD_LIST_SELECTION:
+      case FIELD_RANGE_SELECTION:
+         return DrawSelectionItem(Item, X, Y, Width, FontSize, Bold);
+      default:
+         return 0.0f;
+   }
+}
+
+// replays the ops from the layout pass, the values are looked up from the items
+void CIresMenu::DrawMenuOps(const TIresMenuData& Menu, const std::vector<TMenuOp>& Ops)
+{
+   float font_size = (float)mText->GetFontSize() + 3.0f;
+   float width = Menu.Size.x;
+
+   for (const TMenuOp& op : Ops)
+   {
+      const TIresMenuItem& item = Menu.Items[op.Item];
+
+      switch (op.Op)
+      {
+         case MENU_OP_ITEM:
+            DrawItem(item, op.Position.x, op.Position.y, width, font_size, op.Bold);
+            break;
+         case MENU_OP_LINE:
+            mLine.SetPosition(op.Position, op.Position + glm::vec3(op.Length, 0.0f, 0.0f));
+            mLine.Draw();
+            break;
+         case MENU_OP_CARAT:
+            if (mBoldText)
+               mBoldText->Print(">", op.Position.x, op.Position.y);
+            break;
+         case MENU_OP_DIAMOND:
+         {
+            glm::vec3 p1 = op.Position;
+            glm::vec3 p2 = p1 + glm::vec3(font_size/4.0, -font_size/4.0, 0.0f);
+            glm::vec3 p3 = p1 + glm::vec3(-font_size/4.0, -font_size/4.0, 0.0f);
+            glm::vec3 p4 = p1 + glm::vec3(0.0f, -font_size/2.0, 0.0f);
+            mPolygon.DrawQuad(p1, p2, p3, p4);
+            break;
+         }
+         case MENU_OP_HIGHLIGHT:
+            mPolygon.DrawQuad(op.Position.x - 14.0f, op.Position.y + 4.0f, op.Length, -font_size);
+
+            mText->SetColor(mBackgroundColor);
+            mPolygon.SetColor(mBackgroundColor);
+
+            DrawItem(item, op.Position.x, op.Position.y, width, font_size, false);
+
+            mText->SetColor(mTextColor);
+            mPolygon.SetColor(mTextColor);
+            break;
+         default:
+            break;
       }
+   }
+}
 
-      if (Bottom)
+static glm::vec4 MenuColor(const TIresMenuColor& Color)
+{
+   return glm::vec4((float)Color.Red / 255.0f,
+                    (float)Color.Green / 255.0f,
+                    (float)Color.Blue / 255.0f,
+                    (float)Color.Alpha / 255.0f);
+}
+
+static bool SameColor(const TIresMenuColor& A, const TIresMenuColor& B)
+{
+   return (A.Red == B.Red && A.Green == B.Green && A.Blue == B.Blue && A.Alpha == B.Alpha);
+}
+
+// the host resends the config for every color change and menu activation,
+// only rebuild what actually changed, reloading the fonts is what hitches
+void CIresMenu::ApplyConfig(const TIresMenuConfigPdu& Config)
+{
+   bool font_changed = (!mConfigApplied || Config.Font != mConfig.Font || Config.FontSize != mConfig.FontSize);
+   bool text_color_changed = (!mConfigApplied || !SameColor(Config.TextColor, mConfig.TextColor));
+   bool line_changed = (!mConfigApplied || Config.LineWidth != mConfig.LineWidth || !SameColor(Config.LineColor, mConfig.LineColor));
+   bool background_changed = (!mConfigApplied || !SameColor(Config.BackgroundColor, mConfig.BackgroundColor));
+   bool area_changed = (!mConfigApplied || Config.X != mConfig.X || Config.Y != mConfig.Y ||
+                        Config.Width != mConfig.Width || Config.Height != mConfig.Height);
+   bool active_changed = (!mConfigApplied || Config.MenuActive != mConfig.MenuActive);
+
+   mConfig = Config;
+   mConfigApplied = true;
+
+   if (font_changed)
+   {
+      if (mText)
       {
-         if (i == mCursor.CursorLocation)
+         delete mText;
+         mText = nullptr;
+      }
+
+      if (mBoldText)
+      {
+         delete mBoldText;
+         mBoldText = nullptr;
+      }
+
+      // create a font for the menu
+      if (mConfig.Font >= 0 && mConfig.Font < FONT_COUNT)
+      {
+         mText = new CText(mProjection, mConfig.FontSize, IresMenuFontStr[mConfig.Font]);
+         if (!mText->IsInitialized())
          {
-            float cursor_x;
-            float cursor_y;
-            
-            if (Items[i].Type == FIELD_ACTION_BOT)
-            {
-               cursor_x = x - font_size - 4.0f - (width + font_size * 3.0f);
-               cursor_y = y;
-            }
-            else
-            {
-               cursor_x = x - font_size - 4.0f;
-               cursor_y = y - font_size;
-            }
+            delete mText;
+            mText = nullptr;
+         }
 
-            switch (mCursor.CursorType)
-            {
-               case CURSOR_CARAT:
-                  mBoldText->Print(">", cursor_x, cursor_y);
-                  break;
-               case CURSOR_DIAMOND:
-               {
-                  glm::vec3 p1 = glm::vec3(cursor_x, cursor_y, 0.0f);
-                  glm::vec3 p2 = p1 + glm::vec3(font_size/4.0, -font_size/4.0, 0.0f);
-                  glm::vec3 p3 = p1 + glm::vec3(-font_size/4.0, -font_size/4.0, 0.0f);
-                  glm::vec3 p4 = p1 + glm::vec3(0.0f, -font_size/2.0, 0.0f);
-                  mPolygon.DrawQuad(p1, p2, p3, p4);
-                  break;
-               }
-               case CURSOR_HIGHLIGHT:
-               {
-                  float length = (width + font_size * 4.25f) - font_size*3;
-                  int   indent_level = Items[i].Appearance & 0x7;
-                  float indent = font_size * indent_level;
-
-                  mPolygon.DrawQuad((font_size + 4.0f) + cursor_x - 14.0f + indent, cursor_y + 4.0f, length, -font_size);
-
-                  mText->SetColor(mBackgroundColor);
-                  mPolygon.SetColor(mBackgroundColor);
-
-                  switch (Items[i].Type)
-                  {
-                     case FIELD_ACTION:
-                     case FIELD_ACTION_BOT:
-                        DrawActionItem(Items[i], (font_size + 4.0f) + cursor_x + indent, cursor_y, Width, font_size, false);
-                        break;
-                     case FIELD_STATUS:
-                        DrawStatusItem(Items[i], (font_size + 4.0f) + cursor_x + indent, cursor_y, Width, font_size, false);
-                        break;
-                     case FIELD_SINGLE_SELECTION:
-                     case FIELD_LIST_SELECTION:
-                     case FIELD_RANGE_SELECTION:
-                        DrawSelectionItem(Items[i], (font_size + 4.0f) + cursor_x + indent, cursor_y, Width, font_size, false);
-                        break;
-                     default:
-                        break;
-                  }
-
-                  mText->SetColor(mTextColor);
-                  mPolygon.SetColor(mTextColor);
-                  break;
-               }
-               case CURSOR_BOLD:
-                  // done above
-                  break;
-               default:
-                  break;
-            }
+         mBoldText = new CText(mProjection, mConfig.FontSize, IresMenuFontStr[mConfig.Font+1]);
+         if (!mBoldText->IsInitialized())
+         {
+            delete mBoldText;
+            mBoldText = nullptr;
          }
       }
+
+      BuildWidthCache();
    }
+
+   if (!mConfig.MenuActive && mMenuStack.size())
+      mMenuStack.clear();
+
+   if (background_changed)
+      mBackgroundColor = MenuColor(mConfig.BackgroundColor);
+
+   if (text_color_changed || font_changed)
+   {
+      mTextColor = MenuColor(mConfig.TextColor);
+
+      if (mText)
+      {
+         mText->SetColor(mTextColor);
+         mText->SetInvertY(true);
+      }
+
+      if (mBoldText)
+      {
+         mBoldText->SetColor(mTextColor);
+         mBoldText->SetInvertY(true);
+      }
+
+      mPolygon.SetColor(mTextColor);
+   }
+
+   if (line_changed)
+   {
+      mLineColor = MenuColor(mConfig.LineColor);
+
+      mLine.SetColor(mLineColor);
+      mLine.SetLineWidth(mConfig.LineWidth);
+   }
+
+   if (font_changed || line_changed || background_changed || area_changed || active_changed)
+      mGeometryDirty = true;
+
+   if (font_changed || area_changed || active_changed)
+      mLayoutDirty = true;
+
+   if (font_changed || text_color_changed || line_changed || background_changed || area_changed || active_changed)
+      mCacheDirty = true;
 }
 
 void CIresMenu::ProcessPdu(char* Buffer, int Size)
@@ -1142,75 +1591,7 @@ void CIresMenu::ProcessPdu(char* Buffer, int Size)
                if (config->MenuActive != mConfig.MenuActive)
                   printf("Menu: %s\n", config->MenuActive ? "Active" : "Inactive");
 
-               mConfig = *config;
-
-               if (mText)
-               {
-                  delete mText;
-               }
-
-               if (mBoldText)
-               {
-                  delete mBoldText;
-               }
-
-               // create a font for the menu
-               if (mConfig.Font >= 0 && mConfig.Font < FONT_COUNT)
-               {
-                  mText = new CText(mProjection, mConfig.FontSize, IresMenuFontStr[mConfig.Font]);
-                  if (!mText->IsInitialized())
-                  {
-                     delete mText;
-                     mText = nullptr;
-                  }
-
-                  mBoldText = new CText(mProjection, mConfig.FontSize, IresMenuFontStr[mConfig.Font+1]);
-                  if (!mBoldText->IsInitialized())
-                  {
-                     delete mBoldText;
-                     mBoldText = nullptr;
-                  }
-               }
-
-               if (!config->MenuActive && mMenuStack.size())
-                  mMenuStack.clear();
-
-               // set background color
-               mBackgroundColor = glm::vec4((float)mConfig.BackgroundColor.Red / 255.0f,
-                                            (float)mConfig.BackgroundColor.Green / 255.0f,
-                                            (float)mConfig.BackgroundColor.Blue / 255.0f,
-                                            (float)mConfig.BackgroundColor.Alpha / 255.0f);
-
-               mBackground.SetColor(mBackgroundColor);
-
-               // set text color
-               mTextColor = glm::vec4((float)mConfig.TextColor.Red / 255.0f,
-                                      (float)mConfig.TextColor.Green / 255.0f,
-                                      (float)mConfig.TextColor.Blue / 255.0f,
-                                      (float)mConfig.TextColor.Alpha / 255.0f);
-
-               if (mText)
-               {
-                  mText->SetColor(mTextColor);
-                  mText->SetInvertY(true);
-               }
-
-               if (mBoldText)
-               {
-                  mBoldText->SetColor(mTextColor);
-                  mBoldText->SetInvertY(true);
-               }
-
-               mPolygon.SetColor(mTextColor);
-
-               // set line color
-               mLineColor = glm::vec4((float)mConfig.LineColor.Red / 255.0f,
-                                      (float)mConfig.LineColor.Green / 255.0f,
-                                      (float)mConfig.LineColor.Blue / 255.0f,
-                                      (float)mConfig.LineColor.Alpha / 255.0f);
-
-               mLine.SetColor(mLineColor);
-               mLine.SetLineWidth(mConfig.LineWidth);
+               ApplyConfig(*config);
 
                index += sizeof(TIresMenuConfigPdu);
 
@@ -1255,11 +1636,15 @@ void CIresMenu::ProcessPdu(char* Buffer, int Size)
                   assert(item_pdu->Index == menu_data.Items.size());
 
                   index += UnpackMenuItemPdu(item_pdu, item);
+                  UpdateMtiTrackSettings(item);
 
                   menu_data.Items.push_back(item);
                }
 
                mMenuStack.push_back(menu_data);
+               mGeometryDirty = true;
+               mLayoutDirty = true;
+               mCacheDirty = true;
 
                printf("Menu: got menu PDU for %s with %zu items, stack size %zu\n", title, menu_data.Items.size(), mMenuStack.size());
 
@@ -1276,6 +1661,9 @@ void CIresMenu::ProcessPdu(char* Buffer, int Size)
                assert(item_pdu->Index < mMenuStack[menu_index-1].Items.size());
 
                index += UnpackMenuItemPdu(item_pdu, mMenuStack[menu_index-1].Items[item_pdu->Index]);
+               UpdateMtiTrackSettings(mMenuStack[menu_index-1].Items[item_pdu->Index]);
+               mLayoutDirty = true;
+               mCacheDirty = true;
 
                break;
             }
@@ -1286,7 +1674,13 @@ void CIresMenu::ProcessPdu(char* Buffer, int Size)
                index += sizeof(TIresMenuHeader);
 
                cursor = (TIresMenuCursorPdu*)&Buffer[index];
+
+               // a bold cursor is drawn as part of the item, any other cursor is an overlay
+               if (cursor->CursorType == CURSOR_BOLD || mCursor.CursorType == CURSOR_BOLD)
+                  mCacheDirty = true;
+
                mCursor = *cursor;
+               mLayoutDirty = true;
 
                index += sizeof(TIresMenuCursorPdu);
                break;
@@ -1299,13 +1693,17 @@ void CIresMenu::ProcessPdu(char* Buffer, int Size)
          if (index >= Size)
             processing = false;
       }
+
+      // lay the menus out once per PDU batch instead of every frame
+      if (mLayoutDirty)
+         LayoutMenus();
    }
 }
 
 int CIresMenu::UnpackMenuItemPdu(const TIresMenuItemPdu* ItemPdu, TIresMenuItem& Item)
 {
    int   pdu_size = sizeof(TIresMenuItemPdu);
-   int   bytes_to_copy = 0;
+   int   bytes_to_copy = IresDataSize(ItemPdu->DataType);
    char* buffer = (char*)ItemPdu;
 
    Item.Id = (eIresMenu)ItemPdu->Id;
@@ -1316,36 +1714,52 @@ int CIresMenu::UnpackMenuItemPdu(const TIresMenuItemPdu* ItemPdu, TIresMenuItem&
 
    buffer += pdu_size;
 
-   switch (ItemPdu->DataType)
+   if (bytes_to_copy > 0)
+      memcpy(&Item.Data.Value, buffer, bytes_to_copy);
+
+   pdu_size += bytes_to_copy;
+
+   return pdu_size;
+}
+
+void CIresMenu::UpdateMtiTrackSettings(const TIresMenuItem& Item)
+{
+   TMtiTrackSettings settings = mMtiSettings;
+   uint8_t           value = Item.Data.Value;
+
+   switch (Item.Id)
    {
-      case IRES_B8:
-      case IRES_U8:
-      case IRES_I8:
-         bytes_to_copy = 1;
+      case MENU_LVL2_MTI_MARITIME_MODE:
+         settings.Maritime = (value == 1);
          break;
-      case IRES_U16:
-      case IRES_I16:
-      case IRES_MENU: // 2 bytes are stuffed onto menus for (alarm/mode)
-         bytes_to_copy = 2;
+      case MENU_LVL2_MTI_LAND_BOX_COLOR:
+         settings.LandBoxColor = (value < MTI_COLOR_COUNT) ? (eMtiBoxColor)value : MTI_COLOR_WHITE;
          break;
-      case IRES_U32:
-      case IRES_I32:
-      case IRES_F32:
-         bytes_to_copy = 4;
+      case MENU_LVL2_MTI_MARITIME_BOX_COLOR:
+         settings.MaritimeBoxColor = (value < MTI_COLOR_COUNT) ? (eMtiBoxColor)value : MTI_COLOR_WHITE;
          break;
-      case IRES_U64:
-      case IRES_I64:
-      case IRES_F64:
-         bytes_to_copy = 8;
+      case MENU_LVL2_MTI_BREADCRUMBS:
+         settings.Breadcrumbs = (value != 0);
          break;
-      default:
+      case MENU_LVL2_MTI_MAX_BREADCRUMBS:
+         settings.MaxBreadcrumbs = value;
+         break;
+      case MENU_LVL2_MTI_MAX_BREADCRUMBS_LIFESPAN:
+         settings.BreadcrumbLifespan = value;
          break;
+      default:
+         return;
    }
 
-   if (bytes_to_copy > 0)
-      memcpy(&Item.Data.Value, buffer, bytes_to_copy);
-
-   pdu_size += bytes_to_copy;
-
-   return pdu_size;
+   // the host resends the whole MTI menu, only count real changes
+   if (settings.Maritime != mMtiSettings.Maritime ||
+       settings.LandBoxColor != mMtiSettings.LandBoxColor ||
+       settings.MaritimeBoxColor != mMtiSettings.MaritimeBoxColor ||
+       settings.Breadcrumbs != mMtiSettings.Breadcrumbs ||
+       settings.MaxBreadcrumbs != mMtiSettings.MaxBreadcrumbs ||
+       settings.BreadcrumbLifespan != mMtiSettings.BreadcrumbLifespan)
+   {
+      settings.Generation++;
+      mMtiSettings = settings;
+   }
 }
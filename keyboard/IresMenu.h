@@ -38,21 +38,60 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include "IresMenuTypes.h"
+#include "IresTypes.h"
 #include "Line.h"
 #include "CText.h"
+#include "RetainedGeometry.h"
 
 class CIresMenu
 {
 public:
 
+   enum eMenuOp
+   {
+      MENU_OP_ITEM,       // label and value of Item, bold if Bold
+      MENU_OP_LINE,       // separator starting at Position, Length wide
+      MENU_OP_CARAT,      // cursors, Position is the cursor location
+      MENU_OP_DIAMOND,
+      MENU_OP_HIGHLIGHT   // Length wide bar with Item redrawn inverted at Position
+   };
+
+   // one positioned draw from the layout pass
+   struct TMenuOp
+   {
+      eMenuOp   Op;
+      size_t    Item;
+      glm::vec3 Position;
+      float     Length;
+      bool      Bold;
+   };
+
    struct TIresMenuData
    {
       glm::vec3                  Position;
       glm::vec3                  Size;
       char                       Title[MAX_MENU_NAME_SIZE];
       std::vector<TIresMenuItem> Items;
+      std::vector<TMenuOp>       Ops;         // built by LayoutMenuItems(), replayed into the cache
+      std::vector<TMenuOp>       CursorOps;   // drawn over the cache every frame
+   };
+
+   // MTI track display settings from the last MTI menu items the host sent,
+   // counts and lifespan are negative until the host has sent them
+   struct TMtiTrackSettings
+   {
+      bool         Maritime;            // MENU_LVL2_MTI_MARITIME_MODE
+      eMtiBoxColor LandBoxColor;
+      eMtiBoxColor MaritimeBoxColor;
+      bool         Breadcrumbs;
+      int          MaxBreadcrumbs;
+      float        BreadcrumbLifespan;  // seconds
+      unsigned int Generation;          // bumped whenever a setting changes
+
+      eMtiBoxColor BoxColor() const { return Maritime ? MaritimeBoxColor : LandBoxColor; }
    };
 
    CIresMenu(glm::mat4& Projection);
@@ -61,29 +100,74 @@ public:
    void Draw();
    void ProcessPdu(char* Buffer, int Size);
 
+   // deactivates the menu as if the host had sent an inactive config,
+   // e.g. when the host has stopped sending
+   void Close();
+
+   // size of the window the menus are drawn and cached for, rebuilds the
+   // projection, queried from the viewport if never set
+   void Resize(int Width, int Height);
+
+   const TMtiTrackSettings& GetMtiTrackSettings() const { return mMtiSettings; }
+
 private:
 
    float DrawActionItem(const TIresMenuItem& Item, float X, float Y, float Width, float FontSize, bool Bold);
    float DrawSelectionItem(const TIresMenuItem& Item, float X, float Y, float Width, float FontSize, bool Bold);
    float DrawStatusItem(const TIresMenuItem& Item, float X, float Y, float Width, float FontSize, bool Bold);
    void DrawBackground(bool BackgroundOnly = false);
-   void DrawMenuBorder(TIresMenuData* Menu);
-   void DrawMenuItems(const std::vector<TIresMenuItem>& Items, glm::vec3 Start, float Width, bool Bottom);
+   void DrawMenuBorder(size_t Index);
+   float DrawItem(const TIresMenuItem& Item, float X, float Y, float Width, float FontSize, bool Bold);
+   void DrawMenuOps(const TIresMenuData& Menu, const std::vector<TMenuOp>& Ops);
+   void DrawMenus();
+   bool CreateMenuCache();
+   void DeleteMenuCache();
+   void RenderMenuCache();
+   void DrawMenuCache();
+   void LayoutMenus();
+   void LayoutMenuItems(TIresMenuData& Menu, bool Bottom);
+   float GetItemWidth(const TIresMenuItem& Item, bool Bold);
    int UnpackMenuItemPdu(const TIresMenuItemPdu* ItemPdu, TIresMenuItem& Item);
+   void UpdateMtiTrackSettings(const TIresMenuItem& Item);
+   void UpdateGeometry();
+   void ApplyConfig(const TIresMenuConfigPdu& Config);
+   void BuildWidthCache();
+   void AddWidths(const char** Table, size_t Count);
+   float GetStringWidth(const char* Text);
 
    TIresMenuConfigPdu         mConfig;
+   bool                       mConfigApplied;   // mConfig came from the host, diff against it
    TIresMenuCursorPdu         mCursor;
    std::vector<TIresMenuData> mMenuStack;
    CLine                      mLine;
-   CLine                      mBackground;
+   CRetainedGeometry          mGeometry;
+   int                        mBackgroundQuad;
+   int                        mBackgroundBorder;
+   std::vector<int>           mMenuQuads;   // retained shapes per menu stack level
+   std::vector<int>           mMenuBorders;
+   bool                       mGeometryDirty;
+   bool                       mLayoutDirty;
+   GLuint                     mCacheFbo;      // whole menu stack rendered offscreen
+   GLuint                     mCacheTexture;
+   GLuint                     mCacheStencil;
+   int                        mCacheWidth;
+   int                        mCacheHeight;
+   bool                       mCacheDirty;
+   bool                       mCacheFailed;   // no FBO, draw the menus directly
+   unsigned int               mFontGeneration; // CText font generation the widths were measured with
    CLine                      mPolygon;
    CText*                     mText;
    CText*                     mBoldText;
+   std::unordered_map<const char*, float> mStringWidths; // constant strings measured in mText's font
    glm::mat4                  mProjection;
    glm::vec4                  mTextColor;
    glm::vec4                  mLineColor;
    glm::vec4                  mBackgroundColor;
    bool                       mClipEnabled;
+   TMtiTrackSettings          mMtiSettings;
+
+   static CShader*            mBlitShader;
+   static GLuint              mBlitVao;
 
 };
 
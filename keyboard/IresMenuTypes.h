@@ -274,6 +274,32 @@ enum eIresDataType
    IRES_DATA_TYPE_COUNT
 };
 
+// bytes of data packed after a TIresMenuItemPdu of the given data type
+inline int IresDataSize(uint8_t DataType)
+{
+   switch (DataType)
+   {
+      case IRES_B8:
+      case IRES_U8:
+      case IRES_I8:
+         return 1;
+      case IRES_U16:
+      case IRES_I16:
+      case IRES_MENU: // 2 bytes are stuffed onto menus for (alarm/mode)
+         return 2;
+      case IRES_U32:
+      case IRES_I32:
+      case IRES_F32:
+         return 4;
+      case IRES_U64:
+      case IRES_I64:
+      case IRES_F64:
+         return 8;
+      default:
+         return 0;
+   }
+}
+
 enum eIresMenuAppearance
 {
    APPEARANCE_NONE = 0,
@@ -331,6 +357,10 @@ enum eIresMenuPdu
    MENU_PDU,
    MENU_ITEM_PDU,
    MENU_CURSOR_PDU,
+
+   // sent from the keyboard to the host
+   MENU_KEY_EVENT_PDU = 1100,
+   MENU_MOUSE_EVENT_PDU,
 };
 
 enum eIresCursor : uint8_t
@@ -420,6 +450,24 @@ struct TIresMenuCursorPdu
    uint8_t CursorLocation;
 };
 
+// the header Length of the event PDUs is the size of the event that follows
+struct TIresMenuKeyEventPdu
+{
+   int32_t Key;        // GLFW_KEY_*
+   int32_t Scancode;
+   uint8_t Action;     // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+   uint8_t Mods;       // GLFW_MOD_* bits
+};
+
+struct TIresMenuMouseEventPdu
+{
+   float   X;          // window pixels, origin at the top left
+   float   Y;
+   int8_t  Button;     // GLFW_MOUSE_BUTTON_*, -1 if the mouse only moved
+   uint8_t Action;     // GLFW_PRESS or GLFW_RELEASE
+   uint8_t Mods;
+};
+
 #pragma pack()
 
 #endif 
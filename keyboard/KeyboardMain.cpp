@@ -6,6 +6,10 @@
 #include <math.h>
 #include "Stopwatch.h"
 #include "Stats.h"
+#include "GlState.h"
+#include "CSymbology.h"
+#include "IresMenu.h"
+#include "PduReceiver.h"
 
 #define VSYNC_ENABLE 1
 
@@ -13,6 +17,7 @@ void processInput(GLFWwindow *window, int k, int s, int action, int mods);
 void MouseCallback(GLFWwindow* window, int button, int action, int mods);
 void reshape(GLFWwindow *window, int width, int height);
 void cursorPositionCallback(GLFWwindow *window, double xpos, double ypos);
+void QueueInputEvent(uint16_t Type, const void *Event, int Size);
 
 // settings
 const unsigned int SCR_WIDTH = 600;
@@ -33,6 +38,9 @@ bool window_move = false;
 int win_x_pos, win_y_pos;
 
 CStats* stats = nullptr;
+CSymbology* symbology = nullptr;
+CIresMenu* menu = nullptr;
+CPduReceiver* receiver = nullptr;
 
 int main(int argc, char *argv[])
 {
@@ -44,6 +52,7 @@ int main(int argc, char *argv[])
    CStopwatch fps_timer;
    CStopwatch total_time;
    CStopwatch sleep_time;
+   unsigned int mti_generation = 0;
 
    // glfw: initialize and configure
    // ------------------------------
@@ -109,15 +118,42 @@ int main(int argc, char *argv[])
    glfwSetCursorPosCallback(window, cursorPositionCallback);
    glfwSwapInterval(VSYNC_ENABLE);
 
-   GLCALL(glEnable(GL_BLEND));
-   GLCALL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+   CGlState::Enable(GL_BLEND);
+   CGlState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
    // setup projection
    glm::mat4 projection = glm::ortho(0.0f, (float)width, 0.0f, (float)height);
    glm::mat4 menu_projection = glm::ortho(0.0f, (float)width, (float)height, 0.0f);
 
+   // loaded once, the per-frame cursor text just references it, loaded up
+   // front so there is always a font to fall back on while others load
+   CText::TFontHandle cursor_font = CText::GetFont(DEFAULT_FONT, 28, true);
+
    stats = new CStats(width, height);
 
+   glm::vec3 window_size((float)width, (float)height, 0.0f);
+   symbology = new CSymbology(projection, window_size, 20, "");
+
+   // menus are driven by PDUs from the host, input events go back to it,
+   // usage: Keyboard <host ip> <send port> <receive port> [busy poll us] [recorder ip] [recorder port]
+   if (argc >= 4)
+   {
+      menu = new CIresMenu(menu_projection);
+      menu->Resize(width, height);
+
+      receiver = new CPduReceiver();
+      if (!receiver->Start(argv[1], atoi(argv[2]), atoi(argv[3]), (argc >= 5) ? atoi(argv[4]) : 0))
+      {
+         delete receiver;
+         receiver = nullptr;
+      }
+      else if (argc >= 7)
+      {
+         // a recorder gets a copy of every event sent to the host
+         receiver->AddDestination(argv[5], atoi(argv[6]));
+      }
+   }
+
    // render loop
    // -----------
    while (!glfwWindowShouldClose(window))
@@ -133,6 +169,16 @@ int main(int argc, char *argv[])
             stats = new CStats(width, height);
          }
 
+         if (symbology)
+         {
+            glm::vec3 window_size((float)width, (float)height, 0.0f);
+
+            symbology->Resize(projection, window_size);
+         }
+
+         if (menu)
+            menu->Resize(width, height);
+
          resize = false;
       }
 
@@ -142,15 +188,55 @@ int main(int argc, char *argv[])
          total_time.Start();
       }
 
+      CText::UploadFonts();
+
+      // pick up the newest host state once, it stays put for the whole frame
+      if (symbology)
+         symbology->LatchHost();
+
+      if (receiver)
+      {
+         // scoped timer for processing the PDUs received since last frame
+         CStopwatch stopwatch(stats ? &stats->Timer(CStats::TIMER_PROCESS_PDU) : nullptr);
+
+         for (TPduSlot* slot = receiver->Front(); slot; slot = receiver->Front())
+         {
+            menu->ProcessPdu(slot->Data, slot->Size);
+            receiver->Pop();
+         }
+
+         if (receiver->MenuCloseRequested())
+            menu->Close();
+
+         // the MTI menu drives the track box color and breadcrumbs
+         const CIresMenu::TMtiTrackSettings& mti = menu->GetMtiTrackSettings();
+
+         if (symbology && mti.Generation != mti_generation)
+         {
+            symbology->SetTrackSettings(mti.BoxColor(), mti.Breadcrumbs, mti.MaxBreadcrumbs, mti.BreadcrumbLifespan);
+            mti_generation = mti.Generation;
+         }
+      }
+
       GLCALL(glClearColor(0.2f, 0.2f, 0.2f, 0.95f));
       GLCALL(glClear(GL_COLOR_BUFFER_BIT));
 
+      // nothing calls CSymbology::UpdateHost() yet, so there is no host state
+      // worth drawing, the symbology only tracks the menu settings for now
       if (stats)
       {
          // scoped timer for symbology drawing
          CStopwatch stopwatch(&stats->Timer(CStats::TIMER_SYMB_DRAW));
       }
 
+      if (menu)
+      {
+         // scoped timer for menu drawing
+         CStopwatch stopwatch(stats ? &stats->Timer(CStats::TIMER_MENU_DRAW) : nullptr);
+
+         menu->Draw();
+      }
+
       stats->Timer(CStats::TIMER_TOTAL) = total_time.GetTime();
 
       int mouse_over = -1;
@@ -192,7 +278,7 @@ int main(int argc, char *argv[])
 
       if (cursor_enabled)
       {
-         CText cursorPosition(menu_projection, 28);
+         CText cursorPosition(menu_projection, cursor_font);
          cursorPosition.SetInvertY(true);
 
          // if cursor is close to right edge, move test
@@ -209,6 +295,10 @@ int main(int argc, char *argv[])
          cursorPosition.Print(temp, (float)x_pos - move_left, (float)y_pos - move_down, 1.0f, green);
       }
 
+      // draw all geometry and text queued this frame
+      CLine::Flush();
+      CText::Flush();
+
       sleep_time.Start();
 
       // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
@@ -216,6 +306,10 @@ int main(int argc, char *argv[])
       glfwSwapBuffers(window);
       glfwPollEvents();
 
+      // everything the callbacks queued goes to the host in one burst
+      if (receiver)
+         receiver->FlushSends();
+
       if (window_move)
       {
          glfwGetWindowPos(window, &win_x_pos, &win_y_pos);
@@ -234,6 +328,19 @@ int main(int argc, char *argv[])
 
    // glfw: terminate, clearing all previously allocated GLFW resources.
    // ------------------------------------------------------------------
+   if (receiver)
+   {
+      receiver->Stop();
+      delete receiver;
+   }
+
+   // menu and symbology own GL objects, release them while the context is still around
+   if (menu)
+      delete menu;
+
+   if (symbology)
+      delete symbology;
+
    glfwTerminate();
 
    if (stats)
@@ -243,8 +350,29 @@ int main(int argc, char *argv[])
    return EXIT_SUCCESS;
 }
 
+// queues one input event for the host, sent with the rest of the frame's
+// events after glfwPollEvents()
+void QueueInputEvent(uint16_t Type, const void *Event, int Size)
+{
+   char             buffer[64];  // header plus the largest event
+   TIresMenuHeader *header = (TIresMenuHeader*)buffer;
+
+   if (!receiver || Size > (int)(sizeof(buffer) - sizeof(TIresMenuHeader)))
+      return;
+
+   header->Type = Type;
+   header->Length = (uint16_t)Size;
+   memcpy(&buffer[sizeof(TIresMenuHeader)], Event, Size);
+
+   receiver->QueueSend(buffer, (int)sizeof(TIresMenuHeader) + Size);
+}
+
 void cursorPositionCallback(GLFWwindow *window, double xpos, double ypos)
 {
+   TIresMenuMouseEventPdu event = { (float)xpos, (float)ypos, -1, 0, 0 };
+
+   QueueInputEvent(MENU_MOUSE_EVENT_PDU, &event, sizeof(event));
+
    x_pos = xpos;
    y_pos = ypos;
 
@@ -264,6 +392,10 @@ void cursorPositionCallback(GLFWwindow *window, double xpos, double ypos)
 // ---------------------------------------------------------------------------------------------------------
 void processInput(GLFWwindow *window, int k, int s, int action, int mods)
 {
+   TIresMenuKeyEventPdu event = { k, s, (uint8_t)action, (uint8_t)mods };
+
+   QueueInputEvent(MENU_KEY_EVENT_PDU, &event, sizeof(event));
+
    if (action != GLFW_PRESS)
       return;
 
@@ -323,6 +455,14 @@ void processInput(GLFWwindow *window, int k, int s, int action, int mods)
 
 void MouseCallback(GLFWwindow *window, int button, int action, int mods)
 {
+   double                 xpos, ypos;
+   TIresMenuMouseEventPdu event;
+
+   glfwGetCursorPos(window, &xpos, &ypos);
+   event = { (float)xpos, (float)ypos, (int8_t)button, (uint8_t)action, (uint8_t)mods };
+
+   QueueInputEvent(MENU_MOUSE_EVENT_PDU, &event, sizeof(event));
+
    if (!stats)
       return;
 
@@ -331,8 +471,6 @@ void MouseCallback(GLFWwindow *window, int button, int action, int mods)
       case GLFW_MOUSE_BUTTON_LEFT:
          if (action == GLFW_PRESS && !window_move)
          {
-            double xpos, ypos;
-            glfwGetCursorPos(window, &xpos, &ypos);
             glfwGetWindowPos(window, &win_x_pos, &win_y_pos);
 
             if (!window_move)
@@ -1,12 +1,21 @@
+#include <string.h>
+#include <algorithm>
 #include "Line.h"
+#include "GlState.h"
 
 CShader *CLine::mShader = nullptr;
+GLuint CLine::mStreamVbo = 0;
+GLuint CLine::mStreamVao = 0;
+size_t CLine::mStreamSize = STREAM_BUFFER_VERTICES;
+size_t CLine::mStreamOffset = 0;
+vector<CLine::Batch> CLine::mBatches;
+std::map<std::pair<float, float>, CLine::SectorMesh> CLine::mSectors;
 
 CLine::CLine() : mStartPoint(vec3(0.0f, 0.0f, 0.0f)),
                  mEndPoint(vec3(0.0f, 0.0f, 0.0f)),
                  mWindowSize(vec3(1920.0f, 1080.0f, 0.0f)),
                  w(1920.0f), h(1080.0f), mLineWidth(-1.0f),
-                 mCompat(false),
+                 mCompat(false), mPixelSpace(false),
                  MVP(1.0f), mModel(1.0f), mView(1.0), mClipPlane(1.0)
 {
    if (!mShader)
@@ -17,10 +26,6 @@ CLine::CLine() : mStartPoint(vec3(0.0f, 0.0f, 0.0f)),
 
    VBO = 0;
    VAO = 0;
-   x1 = 0.0f;
-   y1 = 0.0f;
-   x2 = 0.0f;
-   y2 = 0.0f;
    lineColor = glm::vec4(0, 1, 0, 1);
    pattern = 0xFFFF; // solid line
    resolution = 0;
@@ -33,7 +38,7 @@ CLine::CLine(vec3 windowSize, bool compat) : mStartPoint(vec3(0.0f, 0.0f, 0.0f))
                                              mEndPoint(vec3(0.0f, 0.0f, 0.0f)),
                                              mWindowSize(windowSize),
                                              w(windowSize.x), h(windowSize.y), mLineWidth(-1.0f),
-                                             mCompat(compat),
+                                             mCompat(compat), mPixelSpace(false),
                                              MVP(1.0f), mModel(1.0f), mView(1.0), mClipPlane(1.0)
 {
    if (!mShader)
@@ -44,10 +49,6 @@ CLine::CLine(vec3 windowSize, bool compat) : mStartPoint(vec3(0.0f, 0.0f, 0.0f))
 
    VBO = 0;
    VAO = 0;
-   x1 = 0.0f;
-   y1 = 0.0f;
-   x2 = 0.0f;
-   y2 = 0.0f;
    lineColor = glm::vec4(0, 1, 0, 1);
    pattern = 0xFFFF; // solid line
    dashsize = 1;     //?
@@ -65,6 +66,7 @@ void CLine::DrawQuad(float X, float Y, float Width, float Height)
    glm::vec3 p4 = p1 + glm::vec3(Width, Height, 0.0f);
 
    mVertices.clear();
+   mPixelSpace = false;
 
    mVertices.push_back(p1);
    mVertices.push_back(p2);
@@ -81,6 +83,7 @@ void CLine::DrawQuad(const vec3 &P1, const vec3 &P2, const vec3 &P3, const vec3
 {
    mLineMode = TRIANGLE;
    mVertices.clear();
+   mPixelSpace = false;
 
    mVertices.push_back(P1);
    mVertices.push_back(P2);
@@ -97,6 +100,7 @@ void CLine::DrawTriangle(const vec3 &P1, const vec3 &P2, const vec3 &P3)
 {
    mLineMode = TRIANGLE;
    mVertices.clear();
+   mPixelSpace = false;
 
    mVertices.push_back(P1);
    mVertices.push_back(P2);
@@ -107,25 +111,26 @@ void CLine::DrawTriangle(const vec3 &P1, const vec3 &P2, const vec3 &P3)
 
 void CLine::Here(vec3 &start, vec3 &end)
 {
-   x1 = start.x;
-   y1 = start.y;
-   x2 = end.x;
-   y2 = end.y;
-
    mStartPoint = start;
    mEndPoint = end;
 
-   SetVertices();
+   mVertices.push_back(start);
+   mVertices.push_back(end);
+   mPixelSpace = true;
 }
 
 void CLine::Here(vec3 &start)
 {
-   x1 = start.x;
-   y1 = start.y;
-
    mStartPoint = start;
 
-   SetVertice();
+   mVertices.push_back(start);
+   mPixelSpace = true;
+}
+
+void CLine::AddPixelPoints(const vec3 *Points, size_t Count)
+{
+   mVertices.insert(mVertices.end(), Points, Points + Count);
+   mPixelSpace = true;
 }
 
 void CLine::SetPosition(const vec3 &start, const vec3 &end)
@@ -139,65 +144,25 @@ void CLine::SetPosition(const vec3 &point)
    mVertices.push_back(point);
 }
 
-void CLine::SetVertice(void)
-{
-   if (!mCompat)
-   {
-      // ADD screen size to get drawing offset at ctr of screen
-      float ctr_x = w / 2;
-      float ctr_y = h / 2;
-
-      x1 += ctr_x;
-      y1 += ctr_y;
-   }
-
-   // convert 3d world space position 2d screen space position
-   x1 = 2 * x1 / w - 1;
-   y1 = 2 * y1 / h - 1;
-
-   // add ctr x,y so it fossets at center
-   mStartPoint.x = x1;
-   mStartPoint.y = y1;
-
-   mVertices.push_back(mStartPoint);
-}
-
-void CLine::SetVertices(void)
+// maps window pixels to NDC, centered on the window unless in compatibility
+// mode where the origin is the lower left corner
+mat4 CLine::PixelToNdc() const
 {
+   mat4  transform(1.0f);
+   float offset = mCompat ? -1.0f : 0.0f;
 
-   if (!mCompat)
-   {
-      // ADD screen size to get drawing offset at ctr of screen
-      float ctr_x = w / 2;
-      float ctr_y = h / 2;
-
-      x1 += ctr_x;
-      y1 += ctr_y;
-      x2 += ctr_x;
-      y2 += ctr_y;
-   }
-
-   // convert 3d world space position 2d screen space position
-   x1 = 2 * x1 / w - 1;
-   y1 = 2 * y1 / h - 1;
-
-   x2 = 2 * x2 / w - 1;
-   y2 = 2 * y2 / h - 1;
-
-   // add ctr x,y so it fossets at center
-   mStartPoint.x = x1;
-   mStartPoint.y = y1;
-   mEndPoint.x = x2;
-   mEndPoint.y = y2;
+   transform[0][0] = 2.0f / w;
+   transform[1][1] = 2.0f / h;
+   transform[3][0] = offset;
+   transform[3][1] = offset;
 
-   mVertices.push_back(mStartPoint);
-   mVertices.push_back(mEndPoint);
+   return transform;
 }
 
 CLine::~CLine()
 {
-   GLCALL(glDeleteVertexArrays(1, &VAO));
-   GLCALL(glDeleteBuffers(1, &VBO));
+   CGlState::DeleteVertexArray(VAO);
+   CGlState::DeleteBuffer(VBO);
 }
 
 CLine &CLine::operator=(CLine &from)
@@ -213,18 +178,28 @@ CLine &CLine::operator=(CLine &from)
    pattern = from.pattern;
    resolution = from.resolution;
    mLineMode = from.mLineMode;
+   mCompat = from.mCompat;
+   mPixelSpace = from.mPixelSpace;
 
    return *this;
 }
 
-// used for polygons
+// used for polygons, re-uploads into the existing buffer if there is one
 GLuint CLine::CreateVAO()
 {
+   if (VAO)
+   {
+      CGlState::BindBuffer(GL_ARRAY_BUFFER, VBO);
+      GLCALL(glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(*mVertices.data()), mVertices.data(), GL_DYNAMIC_DRAW));
+
+      return VAO;
+   }
+
    GLCALL(glGenBuffers(1, &VBO));
    GLCALL(glGenVertexArrays(1, &VAO));
-   GLCALL(glBindVertexArray(VAO));
+   CGlState::BindVertexArray(VAO);
    GLCALL(glEnableVertexAttribArray(0));
-   GLCALL(glBindBuffer(GL_ARRAY_BUFFER, VBO));
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, VBO);
    GLCALL(glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(*mVertices.data()), mVertices.data(), GL_DYNAMIC_DRAW));
    GLCALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0));
 
@@ -234,65 +209,325 @@ GLuint CLine::CreateVAO()
 void CLine::ClearVertices()
 {
    mVertices.clear();
-   GLCALL(glDeleteVertexArrays(1, &VAO));
-   GLCALL(glDeleteBuffers(1, &VBO));
+   mPixelSpace = false;
+   CGlState::DeleteVertexArray(VAO);
+   CGlState::DeleteBuffer(VBO);
 }
 
-int CLine::Draw(bool Clear)
+// appends the vertices to the shared streaming VBO and returns the index of the
+// first one, the buffer is orphaned when it wraps so the driver never has to wait
+// on a draw that is still reading the old contents
+GLint CLine::StreamVertices(const vector<vec3> &Vertices)
 {
-   mShader->use();
+   size_t count = Vertices.size();
+   GLint  first = 0;
 
-   if (mLineMode != DASH)
+   if (!mStreamVao)
    {
-      // need to reset once the above is used
-      dashsize = 0;
-      gapsize = 0;
+      GLCALL(glGenBuffers(1, &mStreamVbo));
+      GLCALL(glGenVertexArrays(1, &mStreamVao));
+      CGlState::BindVertexArray(mStreamVao);
+      GLCALL(glEnableVertexAttribArray(0));
+      CGlState::BindBuffer(GL_ARRAY_BUFFER, mStreamVbo);
+      GLCALL(glBufferData(GL_ARRAY_BUFFER, mStreamSize * sizeof(vec3), NULL, GL_STREAM_DRAW));
+      GLCALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0));
+   }
+   else
+   {
+      CGlState::BindVertexArray(mStreamVao);
+      CGlState::BindBuffer(GL_ARRAY_BUFFER, mStreamVbo);
    }
 
-   if (mLineWidth != -1.0f)
-      GLCALL(glLineWidth(mLineWidth));
+   if (mStreamOffset + count > mStreamSize)
+   {
+      // grow if a single draw doesn't fit, then orphan and start over at the beginning
+      if (count > mStreamSize)
+         mStreamSize = count * 2;
 
-   if (Clear)
-      CreateVAO();
+      GLCALL(glBufferData(GL_ARRAY_BUFFER, mStreamSize * sizeof(vec3), NULL, GL_STREAM_DRAW));
+      mStreamOffset = 0;
+   }
 
-   GLCALL(glBindVertexArray(VAO));
+   void* data;
+   GLCALL(data = glMapBufferRange(GL_ARRAY_BUFFER,
+                                  mStreamOffset * sizeof(vec3),
+                                  count * sizeof(vec3),
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+   if (data)
+   {
+      memcpy(data, Vertices.data(), count * sizeof(vec3));
+      GLCALL(glUnmapBuffer(GL_ARRAY_BUFFER));
+   }
 
-   mShader->setMat4("MVP", MVP);
-   mShader->setVec4("color", lineColor);
-   mShader->setVec2("resolution", glm::vec2(w, h));
-   mShader->setFloat("dashSize", dashsize);
-   mShader->setFloat("gapSize", gapsize);
+   first = (GLint)mStreamOffset;
+   mStreamOffset += count;
+
+   return first;
+}
 
-   switch (mLineMode)
+void CLine::DrawArrays(LineMode Mode, GLint First, GLsizei Count)
+{
+   switch (Mode)
    {
    case DASH:
    {
-      GLCALL(glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)mVertices.size()));
+      GLCALL(glDrawArrays(GL_LINE_STRIP, First, Count));
       break;
    }
    case SOLID:
    {
-      GLCALL(glDrawArrays(GL_LINES, 0, (GLsizei)mVertices.size()));
+      GLCALL(glDrawArrays(GL_LINES, First, Count));
       break;
    }
    case TRIANGLE:
    {
-      GLCALL(glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mVertices.size()));
+      GLCALL(glDrawArrays(GL_TRIANGLES, First, Count));
       break;
    }
    case TRIANGLE_FAN:
    {
-      GLCALL(glDrawArrays(GL_TRIANGLE_FAN, 0, (GLsizei)mVertices.size()));
+      GLCALL(glDrawArrays(GL_TRIANGLE_FAN, First, Count));
       break;
    }
    default:
       break;
    }
+}
+
+vector<vec3>& CLine::GetBatch(LineMode Mode, const mat4 &Mvp)
+{
+   glm::vec2 resolution(w, h);
+
+   // lines without their own width use whatever is current when queued
+   float line_width = (mLineWidth != -1.0f) ? mLineWidth : CGlState::GetLineWidth();
+
+   // only the latest batch can be extended, joining an earlier one would
+   // draw this shape under everything queued since
+   if (!mBatches.empty())
+   {
+      Batch& batch = mBatches.back();
+
+      if (batch.Mode == Mode && batch.Color == lineColor && batch.LineWidth == line_width &&
+          batch.Resolution == resolution && batch.Mvp == Mvp)
+      {
+         return batch.Vertices;
+      }
+   }
+
+   Batch batch;
+   batch.Mode = Mode;
+   batch.Color = lineColor;
+   batch.LineWidth = line_width;
+   batch.Resolution = resolution;
+   batch.Mvp = Mvp;
+
+   mBatches.push_back(batch);
+
+   return mBatches.back().Vertices;
+}
+
+void CLine::Flush()
+{
+   if (mBatches.empty())
+      return;
+
+   mShader->use();
+
+   // batched modes never dash
+   mShader->setFloat("dashSize", 0.0f);
+   mShader->setFloat("gapSize", 0.0f);
+
+   for (size_t i = 0; i < mBatches.size();)
+   {
+      Batch& batch = mBatches[i];
+
+      // drop batches that went unused for a whole frame, keep the rest so their
+      // storage is reused next frame
+      if (batch.Vertices.empty())
+      {
+         mBatches.erase(mBatches.begin() + i);
+         continue;
+      }
+
+      CGlState::LineWidth(batch.LineWidth);
+
+      GLint first = StreamVertices(batch.Vertices);
+
+      mShader->setMat4("MVP", batch.Mvp);
+      mShader->setVec4("color", batch.Color);
+      mShader->setVec2("resolution", batch.Resolution);
+
+      DrawArrays(batch.Mode, first, (GLsizei)batch.Vertices.size());
+
+      batch.Vertices.clear();
+      i++;
+   }
+}
+
+int CLine::Draw(bool Clear)
+{
+   GLint first = 0;
+   mat4  mvp = (mPixelSpace ? MVP * PixelToNdc() : MVP) * mModel;
+
+   if (Clear && mVertices.empty())
+      return 1;
+
+   if (Clear && (mLineMode == SOLID || mLineMode == TRIANGLE))
+   {
+      vector<vec3>& batch = GetBatch(mLineMode, mvp);
+      batch.insert(batch.end(), mVertices.begin(), mVertices.end());
+      mVertices.clear();
+      mPixelSpace = false;
+      return 1;
+   }
+
+   if (Clear && mLineMode == TRIANGLE_FAN)
+   {
+      vector<vec3>& batch = GetBatch(TRIANGLE, mvp);
+      for (size_t i = 1; i + 1 < mVertices.size(); i++)
+      {
+         batch.push_back(mVertices[0]);
+         batch.push_back(mVertices[i]);
+         batch.push_back(mVertices[i + 1]);
+      }
+      mVertices.clear();
+      mPixelSpace = false;
+      return 1;
+   }
+
+   // anything drawn immediately has to land on top of what was queued before it
+   Flush();
+
+   mShader->use();
+
+   if (mLineMode != DASH)
+   {
+      // need to reset once the above is used
+      dashsize = 0;
+      gapsize = 0;
+   }
+
+   if (mLineWidth != -1.0f)
+      CGlState::LineWidth(mLineWidth);
+
+   // transient geometry goes through the streaming VBO, retained geometry
+   // (Draw(false)) keeps using its own VAO from CreateVAO()
+   if (Clear)
+      first = StreamVertices(mVertices);
+   else
+      CGlState::BindVertexArray(VAO);
+
+   mShader->setMat4("MVP", mvp);
+   mShader->setVec4("color", lineColor);
+   mShader->setVec2("resolution", glm::vec2(w, h));
+   mShader->setFloat("dashSize", dashsize);
+   mShader->setFloat("gapSize", gapsize);
+
+   DrawArrays(mLineMode, first, (GLsizei)mVertices.size());
 
    if (Clear)
    {
-      ClearVertices();
+      mVertices.clear();
+      mPixelSpace = false;
    }
 
    return 1;
 }
+
+const CLine::SectorMesh& CLine::GetSector(float InnerRadius, float OuterRadius)
+{
+   std::pair<float, float> key(InnerRadius, OuterRadius);
+   auto it = mSectors.find(key);
+
+   if (it != mSectors.end())
+      return it->second;
+
+   // one wedge (disc) or quad (ring) per step, so a range of steps is a
+   // contiguous range of vertices
+   SectorMesh     mesh = {};
+   vector<vec3>   vertices;
+   const float    step = 2.0f * (float)M_PI / SECTOR_STEPS;
+
+   mesh.VerticesPerStep = (InnerRadius > 0.0f) ? 6 : 3;
+   vertices.reserve(SECTOR_STEPS * mesh.VerticesPerStep);
+
+   for (int i = 0; i < SECTOR_STEPS; i++)
+   {
+      float c0 = cosf(i * step);
+      float s0 = sinf(i * step);
+      float c1 = cosf((i + 1) * step);
+      float s1 = sinf((i + 1) * step);
+
+      vec3 outer0(OuterRadius * c0, OuterRadius * s0, 0.0f);
+      vec3 outer1(OuterRadius * c1, OuterRadius * s1, 0.0f);
+
+      if (InnerRadius > 0.0f)
+      {
+         vec3 inner0(InnerRadius * c0, InnerRadius * s0, 0.0f);
+         vec3 inner1(InnerRadius * c1, InnerRadius * s1, 0.0f);
+
+         vertices.push_back(inner0);
+         vertices.push_back(outer0);
+         vertices.push_back(outer1);
+         vertices.push_back(inner0);
+         vertices.push_back(outer1);
+         vertices.push_back(inner1);
+      }
+      else
+      {
+         vertices.push_back(vec3(0.0f));
+         vertices.push_back(outer0);
+         vertices.push_back(outer1);
+      }
+   }
+
+   GLCALL(glGenBuffers(1, &mesh.Vbo));
+   GLCALL(glGenVertexArrays(1, &mesh.Vao));
+   CGlState::BindVertexArray(mesh.Vao);
+   GLCALL(glEnableVertexAttribArray(0));
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, mesh.Vbo);
+   GLCALL(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vec3), vertices.data(), GL_STATIC_DRAW));
+   GLCALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0));
+
+   return mSectors[key] = mesh;
+}
+
+void CLine::DrawSector(const vec3 &Center, float InnerRadius, float OuterRadius, float StartDeg, float EndDeg)
+{
+   int start = (int)floorf(StartDeg * SECTOR_STEPS / 360.0f);
+   int count = (int)roundf((EndDeg - StartDeg) * SECTOR_STEPS / 360.0f);
+
+   if (count <= 0)
+      return;
+
+   if (count > SECTOR_STEPS)
+      count = SECTOR_STEPS;
+
+   start %= SECTOR_STEPS;
+   if (start < 0)
+      start += SECTOR_STEPS;
+
+   const SectorMesh& mesh = GetSector(InnerRadius, OuterRadius);
+
+   // anything queued before this has to stay underneath it
+   Flush();
+
+   mShader->use();
+
+   CGlState::BindVertexArray(mesh.Vao);
+
+   mShader->setMat4("MVP", MVP * PixelToNdc() * glm::translate(mat4(1.0f), Center));
+   mShader->setVec4("color", lineColor);
+   mShader->setVec2("resolution", glm::vec2(w, h));
+   mShader->setFloat("dashSize", 0.0f);
+   mShader->setFloat("gapSize", 0.0f);
+
+   // the cutout is just the part of the index range that isn't drawn, a range
+   // that wraps past 360 degrees takes a second draw
+   int first_count = std::min(count, SECTOR_STEPS - start);
+
+   DrawArrays(TRIANGLE, start * mesh.VerticesPerStep, first_count * mesh.VerticesPerStep);
+
+   if (count > first_count)
+      DrawArrays(TRIANGLE, 0, (count - first_count) * mesh.VerticesPerStep);
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
 #include <math.h>
 
 // #include <GLFW/glfw3.h>
@@ -14,6 +15,12 @@ using glm::radians;
 using glm::vec3;
 using std::string;
 using std::vector;
+// streaming buffer shared by all lines drawn with Draw(true), sized in vertices
+const size_t STREAM_BUFFER_VERTICES = 64 * 1024;
+
+// rings/sectors are tessellated in 1 degree steps
+const int SECTOR_STEPS = 360;
+
 typedef enum
 {
    SOLID,
@@ -25,6 +32,27 @@ typedef enum
 
 class CLine
 {
+   // vertices queued for one draw at Flush(), solid lines and triangles are
+   // batched (fans are split into triangles), dashed strips are drawn immediately
+   struct Batch
+   {
+      LineMode       Mode;
+      glm::vec4      Color;
+      float          LineWidth;
+      glm::vec2      Resolution;
+      mat4           Mvp;
+      vector<vec3>   Vertices;
+   };
+
+   // tessellated ring for one inner/outer radius pair, kept for the life of
+   // the program since the symbology only uses a handful of sizes
+   struct SectorMesh
+   {
+      GLuint Vao;
+      GLuint Vbo;
+      int    VerticesPerStep;
+   };
+
    unsigned int VBO, VAO;
    vector<glm::vec3> mVertices;
    vec3 mStartPoint;
@@ -32,10 +60,12 @@ class CLine
    vec3 mWindowSize;
    glm::vec4 lineColor;
    static CShader *mShader;
-   float x1;
-   float y1;
-   float x2;
-   float y2;
+   static GLuint mStreamVbo;
+   static GLuint mStreamVao;
+   static size_t mStreamSize;   // capacity of the streaming VBO in vertices
+   static size_t mStreamOffset; // next free vertex in the streaming VBO
+   static vector<Batch> mBatches;
+   static std::map<std::pair<float, float>, SectorMesh> mSectors;
    float w;
    float h;
    float mLineWidth;
@@ -44,6 +74,7 @@ class CLine
    GLfloat gapsize;
    GLint resolution;
    bool mCompat;
+   bool mPixelSpace; // vertices are window pixels, see PixelToNdc()
    LineMode mLineMode;
    mat4 MVP;
    mat4 mModel;
@@ -51,8 +82,11 @@ class CLine
    mat4 mClipPlane;
 
 protected:
-   void SetVertices(void);
-   void SetVertice(void);
+   mat4 PixelToNdc() const;
+   static GLint StreamVertices(const vector<vec3> &Vertices);
+   static void DrawArrays(LineMode Mode, GLint First, GLsizei Count);
+   static const SectorMesh& GetSector(float InnerRadius, float OuterRadius);
+   vector<vec3>& GetBatch(LineMode Mode, const mat4 &Mvp);
 
 public:
    void DrawQuad(float X, float Y, float Width, float Height);
@@ -62,6 +96,11 @@ public:
    void Here(vec3 &start);
    void SetPosition(const vec3 &start, const vec3 &end);
    void SetPosition(const vec3 &point);
+   void SetPositions(const vector<vec3> &points) { mVertices = points; }
+
+   // append points in window pixels (centered unless in compatibility mode),
+   // they are uploaded as is and moved to NDC by the MVP in lines.vs
+   void AddPixelPoints(const vec3 *Points, size_t Count);
    CLine(vec3 windowSize, bool compat = false);
    CLine();
    CLine &operator=(CLine &from);
@@ -88,6 +127,20 @@ public:
       return 1;
    }
 
+   // window pixels that map to NDC for pixel space vertices
+   void SetWindowSize(const vec3 &windowSize)
+   {
+      mWindowSize = windowSize;
+      w = windowSize.x;
+      h = windowSize.y;
+   }
+
+   // placement of the vertices, applied before the pixel-to-NDC transform
+   void SetModel(const mat4 &model)
+   {
+      mModel = model;
+   }
+
    void SetCompatibility(bool shiftOrNot)
    {
       mCompat = shiftOrNot;
@@ -116,4 +169,11 @@ public:
    void SetLineWidth(float LineWidth) { mLineWidth = LineWidth; }
 
    int Draw(bool Clear = true);
+
+   // filled ring (a disc if InnerRadius is 0) centered on Center in window
+   // pixels, covering StartDeg counter-clockwise to EndDeg, from a cached mesh
+   void DrawSector(const vec3 &Center, float InnerRadius, float OuterRadius, float StartDeg, float EndDeg);
+
+   // draw every batch queued by Draw() since the last flush
+   static void Flush();
 };
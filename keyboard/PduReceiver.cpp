@@ -0,0 +1,281 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      PduReceiver
+//! Class:      CPP Source
+//! Filename:   PduReceiver.cpp
+//! Author:     Brian Woodard
+//! Purpose:    Receives menu PDUs on a network thread and hands them to the
+//!             render thread through a lock-free ring.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include "PduReceiver.h"
+
+CPduReceiver::CPduReceiver()
+   : mSocketId(-1),
+     mHeartbeatTimer(-1),
+     mMenuCloseTimer(-1),
+     mRetryTimer(-1),
+     mHostLost(false),
+     mMenuClose(false)
+{
+}
+
+CPduReceiver::~CPduReceiver()
+{
+   Stop();
+}
+
+bool CPduReceiver::Start(char* IpAddr, int SendPort, int ReceivePort, int BusyPollUs)
+{
+   if (mThread.joinable())
+      return true;
+
+   if (!mSocket.Open(IpAddr, SendPort, ReceivePort))
+   {
+      printf("PduReceiver: failed to open %s:%d\n", IpAddr, ReceivePort);
+      return false;
+   }
+
+   if (!mLoop.Open())
+      return false;
+
+   if (BusyPollUs > 0)
+      mLoop.SetBusyPoll(BusyPollUs);
+
+   mSocketId       = mLoop.AddSocket(mSocket, OnReceive, this);
+   mHeartbeatTimer = mLoop.AddTimer(OnHeartbeatLost, this);
+   mMenuCloseTimer = mLoop.AddTimer(OnMenuClose, this);
+   mRetryTimer     = mLoop.AddTimer(OnRingRetry, this);
+
+   if (mSocketId < 0 || mHeartbeatTimer < 0 || mMenuCloseTimer < 0 || mRetryTimer < 0)
+   {
+      mLoop.Close();
+      return false;
+   }
+
+   mThread = std::thread(&CEventLoop::Run, &mLoop);
+
+   return true;
+}
+
+void CPduReceiver::Stop()
+{
+   mLoop.Stop();
+
+   if (mThread.joinable())
+      mThread.join();
+
+   mLoop.Close();
+}
+
+void CPduReceiver::OnReceive(void* Context)
+{
+   ((CPduReceiver*)Context)->Receive();
+}
+
+void CPduReceiver::OnHeartbeatLost(void* Context)
+{
+   CPduReceiver* receiver = (CPduReceiver*)Context;
+
+   receiver->mHostLost = true;
+   printf("PduReceiver: no PDUs from host for %.1f seconds\n", PDU_HEARTBEAT_TIMEOUT);
+}
+
+void CPduReceiver::OnMenuClose(void* Context)
+{
+   ((CPduReceiver*)Context)->mMenuClose = true;
+}
+
+void CPduReceiver::OnRingRetry(void* Context)
+{
+   CPduReceiver* receiver = (CPduReceiver*)Context;
+
+   if (receiver->mRing.WriteAvailable() > 0)
+      receiver->mLoop.EnableSocket(receiver->mSocketId, true);
+   else
+      receiver->mLoop.StartTimer(receiver->mRetryTimer, PDU_RING_RETRY);
+}
+
+void CPduReceiver::Receive()
+{
+   CSimUdpSocket::TDatagram datagrams[MAX_RECEIVE_BATCH];
+   int count = (int)mRing.WriteAvailable();
+
+   if (count == 0)
+   {
+      // ring is full, leave the datagrams queued in the socket until the
+      // render thread catches up
+      mLoop.EnableSocket(mSocketId, false);
+      mLoop.StartTimer(mRetryTimer, PDU_RING_RETRY);
+      return;
+   }
+
+   if (count > MAX_RECEIVE_BATCH)
+      count = MAX_RECEIVE_BATCH;
+
+   for (int i = 0; i < count; i++)
+   {
+      datagrams[i].Buffer   = mRing.WriteSlot(i).Data;
+      datagrams[i].Capacity = MAX_MENU_BUFFER;
+   }
+
+   int received = mSocket.ReceiveBatch(datagrams, count);
+
+   if (received == -1)
+   {
+      printf("PduReceiver: receive failed\n");
+      return;
+   }
+
+   // woken up, but somebody else got there first
+   if (received <= 0)
+      return;
+
+   for (int i = 0; i < received; i++)
+   {
+      int length = datagrams[i].Length;
+
+      TPduSlot& slot = mRing.WriteSlot(i);
+
+      slot.Type = MENU_INVALID_PDU;
+
+      // a truncated datagram (-1) is dropped, ProcessPdu would walk its
+      // headers past the data that actually arrived
+      if (length < 0)
+      {
+         printf("PduReceiver: dropped a PDU larger than %d bytes\n", MAX_MENU_BUFFER);
+         slot.Size = 0;
+      }
+      else
+         slot.Size = Validate(slot.Data, length, slot.Type);
+   }
+
+   mRing.Commit(received);
+
+   // the host is alive, push both deadlines out
+   mLoop.StartTimer(mHeartbeatTimer, PDU_HEARTBEAT_TIMEOUT);
+   mLoop.StartTimer(mMenuCloseTimer, PDU_MENU_CLOSE_TIME);
+
+   if (mHostLost)
+   {
+      mHostLost = false;
+      printf("PduReceiver: host heartbeat restored\n");
+   }
+}
+
+// Walks the PDUs the same way CIresMenu::ProcessPdu does and returns how many
+// bytes of Buffer it may process, 0 if any PDU runs past the datagram.
+int CPduReceiver::Validate(const char* Buffer, int Size, uint16_t& Type)
+{
+   int index = 0;
+
+   while (index < Size)
+   {
+      const TIresMenuHeader* header = (const TIresMenuHeader*)&Buffer[index];
+      int                    start = index;
+
+      index += sizeof(TIresMenuHeader);
+
+      // the header Length may not claim more than the datagram holds
+      if (index > Size || header->Length > Size - start)
+      {
+         printf("PduReceiver: dropped a datagram with a bad PDU header at byte %d\n", start);
+         return 0;
+      }
+
+      if (start == 0)
+         Type = header->Type;
+
+      switch (header->Type)
+      {
+         case MENU_CONFIG_PDU:
+            index += sizeof(TIresMenuConfigPdu);
+            break;
+         case MENU_PDU:
+         {
+            const TIresMenuPdu* menu = (const TIresMenuPdu*)&Buffer[index];
+
+            index += sizeof(TIresMenuPdu);
+
+            // the title is copied into a MAX_MENU_NAME_SIZE buffer
+            const char* title = &Buffer[index];
+            const char* end = (index < Size) ? (const char*)memchr(title, '\0', Size - index) : nullptr;
+
+            if (!end || end - title >= MAX_MENU_NAME_SIZE)
+            {
+               printf("PduReceiver: dropped a menu PDU with a bad title\n");
+               return 0;
+            }
+
+            index += (int)(end - title) + 1;
+
+            for (int i = 0; i < menu->NumMenuItems && index <= Size; i++)
+            {
+               const TIresMenuItemPdu* item = (const TIresMenuItemPdu*)&Buffer[index];
+
+               index += sizeof(TIresMenuItemPdu);
+
+               if (index <= Size)
+                  index += IresDataSize(item->DataType);
+            }
+            break;
+         }
+         case MENU_ITEM_PDU:
+         {
+            const TIresMenuItemPdu* item = (const TIresMenuItemPdu*)&Buffer[index];
+
+            index += sizeof(TIresMenuItemPdu);
+
+            if (index <= Size)
+               index += IresDataSize(item->DataType);
+            break;
+         }
+         case MENU_CURSOR_PDU:
+            index += sizeof(TIresMenuCursorPdu);
+            break;
+         default:
+            // ProcessPdu stops at the first type it doesn't know
+            return start;
+      }
+
+      if (index > Size)
+      {
+         printf("PduReceiver: dropped a datagram with a short type %d PDU at byte %d\n", header->Type, start);
+         return 0;
+      }
+   }
+
+   return Size;
+}
@@ -0,0 +1,121 @@
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      PduReceiver
+//! Class:      CPP Header
+//! Filename:   PduReceiver.h
+//! Author:     Brian Woodard
+//! Purpose:    Receives menu PDUs on a network thread and hands them to the
+//!             render thread through a lock-free ring.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "IresMenuTypes.h"
+#include "SimUdpSocket.h"
+#include "EventLoop.h"
+#include "SpscRing.h"
+
+const int    PDU_RING_SLOTS        = 64;      // power of two
+const double PDU_HEARTBEAT_TIMEOUT = 0.5;     // seconds of silence before the host is reported lost
+const double PDU_MENU_CLOSE_TIME   = (double)MENU_CLOSE_DELAY / MENU_FRAME_RATE;
+const double PDU_RING_RETRY        = 0.001;   // seconds between checks while the ring is full
+
+// one received datagram, checked on the receive thread so ProcessPdu never
+// reads past it. Size is 0 if the datagram was truncated or malformed and
+// stops before the first PDU of an unknown type. Type is the eIresMenuPdu of
+// the first PDU.
+struct TPduSlot
+{
+   int      Size;
+   uint16_t Type;
+   char     Data[MAX_MENU_BUFFER];
+};
+
+// The receive thread sleeps in an event loop until the socket is readable
+// or one of its timers expires, and reads datagrams straight into free ring
+// slots. The render thread drains the ring with Front()/Pop() without any
+// syscalls or locks. If the render thread falls behind, the receive thread
+// stops reading and the socket buffer absorbs the burst.
+//
+// Every batch received restarts a heartbeat watchdog (logs a lost host) and
+// the menu close timer (asks the render thread to close the menu), so a menu
+// isn't left up when the host goes away.
+class CPduReceiver
+{
+public:
+
+   CPduReceiver();
+   ~CPduReceiver();
+
+   // BusyPollUs > 0 busy polls that long before the receive thread sleeps
+   bool Start(char* IpAddr, int SendPort, int ReceivePort, int BusyPollUs = 0);
+   void Stop();
+
+   // render thread only, oldest received PDU or nullptr
+   TPduSlot* Front() { return mRing.Front(); }
+   void Pop() { mRing.Pop(); }
+
+   // render thread only, events sent back to the host are queued during the
+   // frame and flushed once, the receive thread never touches the send side
+   bool AddDestination(char* IpAddr, int Port) { return mSocket.AddDestination(IpAddr, Port); }
+   bool QueueSend(const char* Buffer, int Size) { return mSocket.QueueSend(Buffer, Size); }
+   int  FlushSends() { return mSocket.FlushSends(); }
+
+   // render thread only, true once each time the host has been silent for
+   // MENU_CLOSE_DELAY
+   bool MenuCloseRequested() { return mMenuClose.exchange(false, std::memory_order_relaxed); }
+
+private:
+
+   static void OnReceive(void* Context);
+   static void OnHeartbeatLost(void* Context);
+   static void OnMenuClose(void* Context);
+   static void OnRingRetry(void* Context);
+
+   void Receive();
+
+   static int Validate(const char* Buffer, int Size, uint16_t& Type);
+
+   CSimUdpSocket                       mSocket;
+   CEventLoop                          mLoop;
+   std::thread                         mThread;
+   int                                 mSocketId;
+   int                                 mHeartbeatTimer;
+   int                                 mMenuCloseTimer;
+   int                                 mRetryTimer;
+   bool                                mHostLost;   // receive thread only
+   std::atomic<bool>                   mMenuClose;
+   CSpscRing<TPduSlot, PDU_RING_SLOTS> mRing;
+
+};
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      RetainedGeometry
+//! Class:      CPP Source
+//! Filename:   RetainedGeometry.cpp
+//! Author:     Brian Woodard
+//! Purpose:    Static shapes that are uploaded once and redrawn until dirty.
+//
+//-----------------------------------------------------------------------------
+
+#include "RetainedGeometry.h"
+
+CRetainedGeometry::CRetainedGeometry(const glm::mat4& Projection)
+   : mProjection(Projection),
+     mShapes()
+{
+}
+
+CRetainedGeometry::~CRetainedGeometry()
+{
+   for (size_t i = 0; i < mShapes.size(); i++)
+      delete mShapes[i].Line;
+}
+
+int CRetainedGeometry::Add(LineMode Mode)
+{
+   TShape shape;
+
+   shape.Line = new CLine();
+   shape.Line->SetLineMode(Mode);
+   shape.Line->setMVP(mProjection);
+   shape.Dirty = false;
+
+   mShapes.push_back(shape);
+
+   return (int)mShapes.size() - 1;
+}
+
+void CRetainedGeometry::SetVertices(int Handle, const std::vector<glm::vec3>& Vertices)
+{
+   if (!IsValid(Handle))
+      return;
+
+   mShapes[Handle].Vertices = Vertices;
+   mShapes[Handle].Dirty = true;
+}
+
+void CRetainedGeometry::SetQuad(int Handle, float X, float Y, float Width, float Height)
+{
+   if (!IsValid(Handle))
+      return;
+
+   glm::vec3 p1 = glm::vec3(X, Y, 0.0f);
+   glm::vec3 p2 = p1 + glm::vec3(Width, 0.0f, 0.0f);
+   glm::vec3 p3 = p1 + glm::vec3(0.0f, Height, 0.0f);
+   glm::vec3 p4 = p1 + glm::vec3(Width, Height, 0.0f);
+
+   std::vector<glm::vec3>& vertices = mShapes[Handle].Vertices;
+
+   vertices.clear();
+   vertices.push_back(p1);
+   vertices.push_back(p2);
+   vertices.push_back(p4);
+   vertices.push_back(p1);
+   vertices.push_back(p4);
+   vertices.push_back(p3);
+
+   mShapes[Handle].Dirty = true;
+}
+
+void CRetainedGeometry::SetProjection(const glm::mat4& Projection)
+{
+   mProjection = Projection;
+
+   for (TShape& shape : mShapes)
+      shape.Line->setMVP(mProjection);
+}
+
+void CRetainedGeometry::SetColor(int Handle, const glm::vec4& Color)
+{
+   if (IsValid(Handle))
+      mShapes[Handle].Line->SetColor(Color);
+}
+
+void CRetainedGeometry::SetLineWidth(int Handle, float LineWidth)
+{
+   if (IsValid(Handle))
+      mShapes[Handle].Line->SetLineWidth(LineWidth);
+}
+
+void CRetainedGeometry::MarkDirty(int Handle)
+{
+   if (IsValid(Handle))
+      mShapes[Handle].Dirty = true;
+}
+
+void CRetainedGeometry::Draw(int Handle)
+{
+   if (!IsValid(Handle))
+      return;
+
+   TShape& shape = mShapes[Handle];
+
+   if (shape.Dirty)
+   {
+      shape.Line->SetPositions(shape.Vertices);
+      shape.Line->CreateVAO();
+      shape.Dirty = false;
+   }
+
+   if (shape.Vertices.size())
+      shape.Line->Draw(false);
+}
@@ -0,0 +1,89 @@
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      RetainedGeometry
+//! Class:      CPP Header
+//! Filename:   RetainedGeometry.h
+//! Author:     Brian Woodard
+//! Purpose:    Static shapes that are uploaded once and redrawn until dirty.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include "Line.h"
+
+// Shapes that rarely change (backgrounds, borders, frames) are registered
+// once and drawn from their own VAO every frame. The vertices are only sent
+// to the GL again after the shape has been changed and marked dirty.
+class CRetainedGeometry
+{
+public:
+
+   CRetainedGeometry(const glm::mat4& Projection);
+   virtual ~CRetainedGeometry();
+
+   // each shape owns its CLine, a copy would delete them twice
+   CRetainedGeometry(const CRetainedGeometry&) = delete;
+   CRetainedGeometry& operator=(const CRetainedGeometry&) = delete;
+
+   // register a shape and return its handle
+   int Add(LineMode Mode);
+
+   // replace the vertices of a shape, uploaded on the next draw
+   void SetVertices(int Handle, const std::vector<glm::vec3>& Vertices);
+   void SetQuad(int Handle, float X, float Y, float Width, float Height);
+
+   // color and line width are uniforms, changing them doesn't dirty the shape
+   void SetColor(int Handle, const glm::vec4& Color);
+   void SetLineWidth(int Handle, float LineWidth);
+
+   void MarkDirty(int Handle);
+
+   // the projection is a uniform, nothing is uploaded again
+   void SetProjection(const glm::mat4& Projection);
+   bool IsValid(int Handle) const { return Handle >= 0 && Handle < (int)mShapes.size(); }
+
+   void Draw(int Handle);
+
+private:
+
+   struct TShape
+   {
+      CLine*                 Line;
+      std::vector<glm::vec3> Vertices;
+      bool                   Dirty;
+   };
+
+   glm::mat4           mProjection;
+   std::vector<TShape> mShapes;
+
+};
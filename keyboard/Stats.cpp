@@ -41,10 +41,12 @@
 #include "Stats.h"
 #include "IresTypes.h"
 #include "PrintData.h"
+#include "GlState.h"
 
 CStats::CStats(int Width, int Height)
    : mFpsHistory{0.0},
      mMouseOverTimerMs(0.0),
+     mCallsAvoided(0),
      mFpsCount(0),
      mWidth(Width),
      mHeight(Height),
@@ -128,6 +130,9 @@ void CStats::Draw(double FrameTime)
    double fps = 0.0;
    double fps_avg = 0.0;
 
+   // GL state changes skipped since the last frame
+   mCallsAvoided = CGlState::EndFrame();
+
    // do some FPS calculations
    if (FrameTime > 0.0)
       fps = 1.0 / FrameTime;
@@ -168,6 +173,11 @@ void CStats::Draw(double FrameTime)
       mFpsText.SetColor(glm::vec3(1.0f, 0.0f, 0.0f));
       mFpsText.Print("60 Hz", 10.0f, line_y - 20.0f);
 
+      char avoided_str[100];
+      sprintf(avoided_str, "GL calls avoided: %u", mCallsAvoided);
+      mFpsText.SetColor(glm::vec3(0.0f, 1.0f, 0.0f));
+      mFpsText.Print(avoided_str, 125.0f, (float)mHeight - 25.0f);
+
       line_y *= 2.0;
 
       // update timing lines
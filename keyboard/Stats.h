@@ -111,6 +111,7 @@ private:
 
    double    mFpsHistory[FPS_HISTORY];
    double    mMouseOverTimerMs;
+   unsigned  mCallsAvoided;
    int       mFpsCount;
    int       mWidth;
    int       mHeight;
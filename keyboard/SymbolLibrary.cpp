@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      SymbolLibrary
+//! Class:      CPP Source
+//! Filename:   SymbolLibrary.cpp
+//! Author:     Brian Woodard
+//! Purpose:    Reticle shapes built once and placed with a model matrix.
+//
+//-----------------------------------------------------------------------------
+
+#include "SymbolLibrary.h"
+
+CSymbolLibrary::CSymbolLibrary(const glm::vec3& WindowSize)
+   : mSymbols{}
+{
+   std::vector<glm::vec3> points;
+   float off;
+   float len;
+   float gap;
+
+   for (int i = 0; i < SYMBOL_COUNT; i++)
+      mSymbols[i] = new CLine(glm::vec3(WindowSize.x, WindowSize.y, 0.0f));
+
+   // four ticks around the line of sight
+   off = 26;
+   len = 52;
+   points = { { 0.0f,  off,  0.0f }, { 0.0f,  off + len, 0.0f },
+              { 0.0f, -off,  0.0f }, { 0.0f, -off - len, 0.0f },
+              {  off, 0.0f,  0.0f }, {  off + len, 0.0f, 0.0f },
+              { -off, 0.0f,  0.0f }, { -off - len, 0.0f, 0.0f } };
+   Build(SYMBOL_STANDARD_LOS, SOLID, false, points);
+
+   // filled square, positioned from the lower left corner of the window
+   len = 10;
+   points = { { -len / 2, -len / 2, 0.0f }, {  len / 2, -len / 2, 0.0f }, { len / 2,  len / 2, 0.0f },
+              {  len / 2,  len / 2, 0.0f }, { -len / 2,  len / 2, 0.0f }, { -len / 2, -len / 2, 0.0f } };
+   Build(SYMBOL_POINT_LOS, TRIANGLE, true, points);
+
+   // box around the line of sight
+   off = 26;
+   len = 82 + off;
+   points = { { -len,  len, 0.0f }, {  len,  len, 0.0f },
+              { -len, -len, 0.0f }, {  len, -len, 0.0f },
+              {  len,  len, 0.0f }, {  len, -len, 0.0f },
+              { -len,  len, 0.0f }, { -len, -len, 0.0f } };
+   Build(SYMBOL_LASER_ILLUMINATOR, SOLID, false, points);
+
+   // same box with the corners left open
+   gap = 40;
+   points = { { -len + gap,  len, 0.0f }, {  len - gap,  len, 0.0f },
+              { -len + gap, -len, 0.0f }, {  len - gap, -len, 0.0f },
+              {  len,  len - gap, 0.0f }, {  len, -len + gap, 0.0f },
+              { -len,  len - gap, 0.0f }, { -len, -len + gap, 0.0f } };
+   Build(SYMBOL_LASER_DESIGNATOR, SOLID, false, points);
+
+   // dashed box, a closed strip so it is a single draw
+   points = { { -len,  len, 0.0f }, {  len,  len, 0.0f }, {  len, -len, 0.0f },
+              { -len, -len, 0.0f }, { -len,  len, 0.0f } };
+   Build(SYMBOL_ACQUISITION_GATE, DASH, false, points);
+   mSymbols[SYMBOL_ACQUISITION_GATE]->SetDashSize(10.0f);
+   mSymbols[SYMBOL_ACQUISITION_GATE]->SetGapSize(10.0f);
+}
+
+CSymbolLibrary::~CSymbolLibrary()
+{
+   for (int i = 0; i < SYMBOL_COUNT; i++)
+      delete mSymbols[i];
+}
+
+void CSymbolLibrary::Build(eSymbol Symbol, LineMode Mode, bool Compat, const std::vector<glm::vec3>& Points)
+{
+   CLine* line = mSymbols[Symbol];
+
+   line->SetLineMode(Mode);
+   line->SetCompatibility(Compat);
+   line->AddPixelPoints(Points.data(), Points.size());
+   line->CreateVAO();
+}
+
+void CSymbolLibrary::Draw(eSymbol Symbol, float X, float Y, float Rotation)
+{
+   glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(X, Y, 0.0f));
+
+   if (Rotation != 0.0f)
+      model = glm::rotate(model, glm::radians(Rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+
+   Draw(Symbol, model);
+}
+
+void CSymbolLibrary::Draw(eSymbol Symbol, const glm::mat4& Model)
+{
+   if (Symbol < 0 || Symbol >= SYMBOL_COUNT)
+      return;
+
+   mSymbols[Symbol]->SetModel(Model);
+   mSymbols[Symbol]->Draw(false);
+}
+
+void CSymbolLibrary::SetColor(eSymbol Symbol, const glm::vec4& Color)
+{
+   if (Symbol >= 0 && Symbol < SYMBOL_COUNT)
+      mSymbols[Symbol]->SetColor(Color);
+}
+
+void CSymbolLibrary::SetWindowSize(const glm::vec3& WindowSize)
+{
+   for (int i = 0; i < SYMBOL_COUNT; i++)
+      mSymbols[i]->SetWindowSize(glm::vec3(WindowSize.x, WindowSize.y, 0.0f));
+}
@@ -0,0 +1,78 @@
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      SymbolLibrary
+//! Class:      CPP Header
+//! Filename:   SymbolLibrary.h
+//! Author:     Brian Woodard
+//! Purpose:    Reticle shapes built once and placed with a model matrix.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Line.h"
+
+enum eSymbol
+{
+   SYMBOL_STANDARD_LOS,
+   SYMBOL_POINT_LOS,
+   SYMBOL_LASER_ILLUMINATOR,
+   SYMBOL_LASER_DESIGNATOR,
+   SYMBOL_ACQUISITION_GATE,
+
+   SYMBOL_COUNT
+};
+
+// Each reticle is built around its own origin in window pixels and uploaded
+// once, drawing one only sets the model matrix and issues a single draw.
+class CSymbolLibrary
+{
+public:
+
+   CSymbolLibrary(const glm::vec3& WindowSize);
+   virtual ~CSymbolLibrary();
+
+   // X/Y in window pixels, Rotation in degrees counter-clockwise
+   void Draw(eSymbol Symbol, float X, float Y, float Rotation = 0.0f);
+   void Draw(eSymbol Symbol, const glm::mat4& Model);
+
+   void SetColor(eSymbol Symbol, const glm::vec4& Color);
+
+   // keeps the built symbols, only their pixel-to-NDC transform changes
+   void SetWindowSize(const glm::vec3& WindowSize);
+
+private:
+
+   void Build(eSymbol Symbol, LineMode Mode, bool Compat, const std::vector<glm::vec3>& Points);
+
+   CLine* mSymbols[SYMBOL_COUNT];
+
+};
@@ -0,0 +1,234 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      TrackRenderer
+//! Class:      CPP Source
+//! Filename:   TrackRenderer.cpp
+//! Author:     Brian Woodard
+//! Purpose:    Instanced drawing of track symbols and MTI breadcrumbs.
+//
+//-----------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <algorithm>
+#include "TrackRenderer.h"
+#include "GlState.h"
+#include "Line.h"
+
+CShader* CTrackRenderer::mShader = nullptr;
+
+// colors matching eMtiBoxColor
+static const glm::vec4 MtiBoxColors[MTI_COLOR_COUNT] =
+{
+   glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), // MTI_COLOR_WHITE
+   glm::vec4(0.0f, 1.0f, 0.0f, 1.0f), // MTI_COLOR_GREEN
+   glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), // MTI_COLOR_BLUE
+   glm::vec4(1.0f, 1.0f, 0.0f, 1.0f), // MTI_COLOR_YELLOW
+   glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), // MTI_COLOR_MAGENTA
+   glm::vec4(0.0f, 1.0f, 1.0f, 1.0f)  // MTI_COLOR_CYAN
+};
+
+CTrackRenderer::CTrackRenderer(const glm::mat4& Projection, int MaxTracks, int MaxBreadcrumbs)
+   : mProjection(Projection),
+     mMaxTracks(MaxTracks),
+     mMaxBreadcrumbs(MaxBreadcrumbs),
+     mTrackCount(0),
+     mLifespan(DEFAULT_BREADCRUMB_LIFESPAN),
+     mInterval(DEFAULT_BREADCRUMB_INTERVAL),
+     mBreadcrumbsEnabled(true),
+     mTracks(),
+     mInstances(),
+     mDirtyMin(0),
+     mDirtyMax(-1),
+     mVao(0),
+     mMeshVbo(0),
+     mInstanceVbo(0)
+{
+   if (!mShader)
+   {
+      mShader = new CShader("track.vs", "track.fs");
+      std::cout << "Created shader " << mShader->mID << " for tracks" << std::endl;
+   }
+
+   // unit box outline as line pairs, scaled by the instance size
+   const glm::vec2 box[] =
+   {
+      { -0.5f, -0.5f }, {  0.5f, -0.5f },
+      {  0.5f, -0.5f }, {  0.5f,  0.5f },
+      {  0.5f,  0.5f }, { -0.5f,  0.5f },
+      { -0.5f,  0.5f }, { -0.5f, -0.5f }
+   };
+
+   GLCALL(glGenVertexArrays(1, &mVao));
+   GLCALL(glGenBuffers(1, &mMeshVbo));
+   GLCALL(glGenBuffers(1, &mInstanceVbo));
+
+   CGlState::BindVertexArray(mVao);
+
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, mMeshVbo);
+   GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(box), box, GL_STATIC_DRAW));
+   GLCALL(glEnableVertexAttribArray(0));
+   GLCALL(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0));
+
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, mInstanceVbo);
+   GLCALL(glEnableVertexAttribArray(1));
+   GLCALL(glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(TInstance), (void*)offsetof(TInstance, Position)));
+   GLCALL(glVertexAttribDivisor(1, 1));
+   GLCALL(glEnableVertexAttribArray(2));
+   GLCALL(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TInstance), (void*)offsetof(TInstance, Color)));
+   GLCALL(glVertexAttribDivisor(2, 1));
+
+   Allocate();
+}
+
+CTrackRenderer::~CTrackRenderer()
+{
+   CGlState::DeleteVertexArray(mVao);
+   CGlState::DeleteBuffer(mMeshVbo);
+   CGlState::DeleteBuffer(mInstanceVbo);
+}
+
+// (re)size the instance buffer for the current limits, everything starts hidden
+void CTrackRenderer::Allocate()
+{
+   TInstance hidden = { glm::vec2(0.0f), 0.0f, -1.0f, glm::vec4(0.0f) };
+
+   mTracks.assign(mMaxTracks, TTrack{ false, 0, 0.0 });
+   mInstances.assign(mMaxTracks * (mMaxBreadcrumbs + 1), hidden);
+   mTrackCount = 0;
+
+   CGlState::BindBuffer(GL_ARRAY_BUFFER, mInstanceVbo);
+   GLCALL(glBufferData(GL_ARRAY_BUFFER, mInstances.size() * sizeof(TInstance), mInstances.data(), GL_DYNAMIC_DRAW));
+
+   mDirtyMin = 0;
+   mDirtyMax = -1;
+}
+
+void CTrackRenderer::SetMaxBreadcrumbs(int MaxBreadcrumbs)
+{
+   if (MaxBreadcrumbs < 0 || MaxBreadcrumbs == mMaxBreadcrumbs)
+      return;
+
+   // tracks are re-sent by the host every frame, so starting over is fine
+   mMaxBreadcrumbs = MaxBreadcrumbs;
+   Allocate();
+}
+
+void CTrackRenderer::SetInstance(int Index, const TInstance& Instance)
+{
+   mInstances[Index] = Instance;
+
+   if (mDirtyMax < mDirtyMin)
+   {
+      mDirtyMin = Index;
+      mDirtyMax = Index;
+   }
+   else
+   {
+      mDirtyMin = std::min(mDirtyMin, Index);
+      mDirtyMax = std::max(mDirtyMax, Index);
+   }
+}
+
+void CTrackRenderer::UpdateTrack(int Track, float X, float Y, eMtiBoxColor Color, double Time)
+{
+   if (Track < 0 || Track >= mMaxTracks)
+      return;
+
+   TTrack&   track = mTracks[Track];
+   glm::vec4 color = (Color >= 0 && Color < MTI_COLOR_COUNT) ? MtiBoxColors[Color] : MtiBoxColors[MTI_COLOR_WHITE];
+
+   if (!track.Active)
+   {
+      track.Active = true;
+      track.Head = 0;
+      track.LastCrumb = Time - mInterval;
+      mTrackCount = std::max(mTrackCount, Track + 1);
+   }
+
+   SetInstance(Slot(Track, 0), { glm::vec2(X, Y), TRACK_BOX_SIZE, -1.0f, color });
+
+   // drop a crumb into the ring, overwriting the oldest one
+   if (mBreadcrumbsEnabled && mMaxBreadcrumbs > 0 && Time - track.LastCrumb >= mInterval)
+   {
+      SetInstance(Slot(Track, 1 + track.Head), { glm::vec2(X, Y), BREADCRUMB_SIZE, (float)Time, color });
+
+      track.Head = (track.Head + 1) % mMaxBreadcrumbs;
+      track.LastCrumb = Time;
+   }
+}
+
+void CTrackRenderer::RemoveTrack(int Track)
+{
+   if (Track < 0 || Track >= mMaxTracks || !mTracks[Track].Active)
+      return;
+
+   TInstance hidden = { glm::vec2(0.0f), 0.0f, -1.0f, glm::vec4(0.0f) };
+
+   // hide the marker, the crumbs are left to fade out on their own
+   SetInstance(Slot(Track, 0), hidden);
+   mTracks[Track].Active = false;
+}
+
+void CTrackRenderer::Draw(double Time)
+{
+   // upload only the instances touched since the last draw
+   if (mDirtyMax >= mDirtyMin)
+   {
+      CGlState::BindBuffer(GL_ARRAY_BUFFER, mInstanceVbo);
+      GLCALL(glBufferSubData(GL_ARRAY_BUFFER,
+                             mDirtyMin * sizeof(TInstance),
+                             (mDirtyMax - mDirtyMin + 1) * sizeof(TInstance),
+                             &mInstances[mDirtyMin]));
+      mDirtyMin = 0;
+      mDirtyMax = -1;
+   }
+
+   // removed tracks keep their block until the next Allocate() so their
+   // crumbs can finish fading, hidden instances are discarded in the shader
+   int instances = mTrackCount * (mMaxBreadcrumbs + 1);
+
+   if (instances == 0)
+      return;
+
+   // anything queued before this has to stay underneath it
+   CLine::Flush();
+
+   mShader->use();
+   mShader->setMat4("MVP", mProjection);
+   mShader->setFloat("time", (float)Time);
+
+   // with breadcrumbs off an (almost) zero lifespan fades every crumb at once
+   mShader->setFloat("lifespan", mBreadcrumbsEnabled ? mLifespan : 1.0e-6f);
+
+   CGlState::BindVertexArray(mVao);
+   GLCALL(glDrawArraysInstanced(GL_LINES, 0, 8, instances));
+}
@@ -0,0 +1,113 @@
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS � 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  � Veraxx Engineering Corporation, 2023.  All rights reserved.
+// 
+// DEVELOPED BY: 
+//  Veraxx Engineering Corporation 
+//  14130 Sullyfield Circle, Suite B 
+//  Chantilly, VA 20151
+//  www.Veraxx.com 
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//
+//                         Distribution Warning:
+//  WARNING - This file contains technical data whose export is restricted by
+//  the Arms Export Control Act (Title 22, U.S.C., Sec. 2751 et seq.) or
+//  Executive Order 12470. Violations of these export laws are subject to severe
+//  criminal penalties. Disseminate in accordance with provisions of DoD
+//  Directive 5230.25
+//
+//-----------------------------------------------------------------------------
+//  
+//! Title:      TrackRenderer
+//! Class:      CPP Header
+//! Filename:   TrackRenderer.h
+//! Author:     Brian Woodard
+//! Purpose:    Instanced drawing of track symbols and MTI breadcrumbs.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include "CShaderUtils.h"
+#include "IresTypes.h"
+
+const int   DEFAULT_MAX_TRACKS = 256;
+const int   DEFAULT_MAX_BREADCRUMBS = 20;
+const float DEFAULT_BREADCRUMB_LIFESPAN = 10.0f; // seconds
+const float DEFAULT_BREADCRUMB_INTERVAL = 0.5f;  // seconds between crumbs
+const float TRACK_BOX_SIZE = 24.0f;              // pixels
+const float BREADCRUMB_SIZE = 4.0f;              // pixels
+
+// Every track owns a block of instances in one GPU buffer: its marker box
+// followed by a ring of breadcrumbs. Only the instances that change are
+// uploaded, crumbs fade out in the shader, and all tracks and crumbs are
+// drawn with a single instanced call.
+class CTrackRenderer
+{
+public:
+
+   CTrackRenderer(const glm::mat4& Projection, int MaxTracks = DEFAULT_MAX_TRACKS, int MaxBreadcrumbs = DEFAULT_MAX_BREADCRUMBS);
+   virtual ~CTrackRenderer();
+
+   // position in window pixels, Time in seconds from any fixed epoch
+   void UpdateTrack(int Track, float X, float Y, eMtiBoxColor Color, double Time);
+   void RemoveTrack(int Track);
+
+   void SetBreadcrumbsEnabled(bool Enabled) { mBreadcrumbsEnabled = Enabled; }
+   void SetMaxBreadcrumbs(int MaxBreadcrumbs);
+   void SetBreadcrumbLifespan(float Seconds) { mLifespan = Seconds; }
+   void SetProjection(const glm::mat4& Projection) { mProjection = Projection; }
+
+   void Draw(double Time);
+
+private:
+
+   // per-instance data, matches the attributes in track.vs
+   struct TInstance
+   {
+      glm::vec2 Position;
+      float     Size;
+      float     Time;  // when the crumb was laid, -1 for track markers
+      glm::vec4 Color;
+   };
+
+   struct TTrack
+   {
+      bool   Active;
+      int    Head;        // next crumb slot in the ring
+      double LastCrumb;   // time the last crumb was laid
+   };
+
+   void Allocate();
+   void SetInstance(int Index, const TInstance& Instance);
+   int  Slot(int Track, int Index) const { return Track * (mMaxBreadcrumbs + 1) + Index; }
+
+   static CShader*        mShader;
+
+   glm::mat4              mProjection;
+   int                    mMaxTracks;
+   int                    mMaxBreadcrumbs;
+   int                    mTrackCount;       // one past the highest track used since Allocate()
+   float                  mLifespan;
+   float                  mInterval;
+   bool                   mBreadcrumbsEnabled;
+   std::vector<TTrack>    mTracks;
+   std::vector<TInstance> mInstances;        // CPU copy of the instance buffer
+   int                    mDirtyMin;         // range of instances to upload on the next draw
+   int                    mDirtyMax;
+   GLuint                 mVao;
+   GLuint                 mMeshVbo;
+   GLuint                 mInstanceVbo;
+
+};
@@ -0,0 +1,349 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS § 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  © Veraxx Engineering Corporation 2021.  All rights reserved.
+//
+// DEVELOPED BY:
+//  Veraxx Engineering Corporation
+//  14130 Sullyfield Circle, Suite B
+//  Chantilly, VA 20151
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//  Title:      Event Loop
+//  Class:      C++ Source
+//  Filename:   EventLoop.cpp
+//  Author:     Brian Woodard
+//  Purpose:    This module performs the following tasks:
+//
+//  Provides an epoll based event loop that waits on sockets, timers and a
+//  wakeup event, so a thread only runs when there is work to do.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include "EventLoop.h"
+#include "Stopwatch.h"
+
+// epoll data for the wakeup event, sources use their index
+const uint32_t WAKEUP_SOURCE = MAX_EVENT_SOURCES;
+
+CEventLoop::CEventLoop()
+   : mEpoll(-1),
+     mWakeup(-1),
+     mBusyPoll(0),
+     mStopped(false)
+{
+   for (int i = 0; i < MAX_EVENT_SOURCES; i++)
+      mSources[i].Fd = -1;
+}
+
+CEventLoop::~CEventLoop()
+{
+   Close();
+}
+
+bool CEventLoop::Open()
+{
+   struct epoll_event event = {};
+
+   if (mEpoll >= 0)
+      return true;
+
+   mStopped = false;
+
+   mEpoll = epoll_create1(EPOLL_CLOEXEC);
+   if (mEpoll < 0)
+   {
+      perror("EventLoop: epoll_create1()");
+      return false;
+   }
+
+   mWakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if (mWakeup < 0)
+   {
+      perror("EventLoop: eventfd()");
+      Close();
+      return false;
+   }
+
+   event.events   = EPOLLIN;
+   event.data.u32 = WAKEUP_SOURCE;
+
+   if (epoll_ctl(mEpoll, EPOLL_CTL_ADD, mWakeup, &event) < 0)
+   {
+      perror("EventLoop: epoll_ctl()");
+      Close();
+      return false;
+   }
+
+   return true;
+}
+
+void CEventLoop::Close()
+{
+   for (int i = 0; i < MAX_EVENT_SOURCES; i++)
+      Remove(i);
+
+   if (mWakeup >= 0)
+      close(mWakeup);
+
+   if (mEpoll >= 0)
+      close(mEpoll);
+
+   mWakeup = -1;
+   mEpoll = -1;
+}
+
+int CEventLoop::AddSource(int Fd, bool Timer, CSimUdpSocket* Socket, THandler Handler, void* Context)
+{
+   for (int i = 0; i < MAX_EVENT_SOURCES; i++)
+   {
+      if (mSources[i].Fd < 0)
+      {
+         struct epoll_event event = {};
+
+         event.events   = EPOLLIN;
+         event.data.u32 = i;
+
+         if (epoll_ctl(mEpoll, EPOLL_CTL_ADD, Fd, &event) < 0)
+         {
+            perror("EventLoop: epoll_ctl()");
+            return -1;
+         }
+
+         mSources[i].Fd      = Fd;
+         mSources[i].Timer   = Timer;
+         mSources[i].Socket  = Socket;
+         mSources[i].Handler = Handler;
+         mSources[i].Context = Context;
+
+         return i;
+      }
+   }
+
+   printf("EventLoop: more than %d sources\n", MAX_EVENT_SOURCES);
+   return -1;
+}
+
+bool CEventLoop::ValidSource(int Id, bool Timer)
+{
+   return Id >= 0 && Id < MAX_EVENT_SOURCES && mSources[Id].Fd >= 0 && mSources[Id].Timer == Timer;
+}
+
+int CEventLoop::AddSocket(CSimUdpSocket& Socket, THandler Handler, void* Context)
+{
+   if (mEpoll < 0 || !Handler)
+      return -1;
+
+   Socket.SetNonBlockingFlag();
+
+   return AddSource(Socket.GetDescriptor(), false, &Socket, Handler, Context);
+}
+
+int CEventLoop::AddTimer(THandler Handler, void* Context)
+{
+   int fd;
+   int id;
+
+   if (mEpoll < 0 || !Handler)
+      return -1;
+
+   fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+   if (fd < 0)
+   {
+      perror("EventLoop: timerfd_create()");
+      return -1;
+   }
+
+   id = AddSource(fd, true, nullptr, Handler, Context);
+   if (id < 0)
+      close(fd);
+
+   return id;
+}
+
+bool CEventLoop::StartTimer(int Id, double Seconds, bool Repeat)
+{
+   struct itimerspec spec = {};
+
+   if (!ValidSource(Id, true))
+      return false;
+
+   // a zero value would disarm the timer
+   if (Seconds < 1.0e-9)
+      Seconds = 1.0e-9;
+
+   spec.it_value.tv_sec  = (time_t)Seconds;
+   spec.it_value.tv_nsec = (long)((Seconds - (double)spec.it_value.tv_sec) * 1.0e9);
+
+   if (Repeat)
+      spec.it_interval = spec.it_value;
+
+   return timerfd_settime(mSources[Id].Fd, 0, &spec, nullptr) == 0;
+}
+
+bool CEventLoop::StopTimer(int Id)
+{
+   struct itimerspec spec = {};
+
+   if (!ValidSource(Id, true))
+      return false;
+
+   return timerfd_settime(mSources[Id].Fd, 0, &spec, nullptr) == 0;
+}
+
+bool CEventLoop::EnableSocket(int Id, bool Enable)
+{
+   struct epoll_event event = {};
+
+   if (!ValidSource(Id, false))
+      return false;
+
+   event.events   = Enable ? (uint32_t)EPOLLIN : 0u;
+   event.data.u32 = Id;
+
+   return epoll_ctl(mEpoll, EPOLL_CTL_MOD, mSources[Id].Fd, &event) == 0;
+}
+
+void CEventLoop::Remove(int Id)
+{
+   if (Id < 0 || Id >= MAX_EVENT_SOURCES || mSources[Id].Fd < 0)
+      return;
+
+   epoll_ctl(mEpoll, EPOLL_CTL_DEL, mSources[Id].Fd, nullptr);
+
+   if (mSources[Id].Timer)
+      close(mSources[Id].Fd);
+
+   mSources[Id].Fd = -1;
+}
+
+bool CEventLoop::SetBusyPoll(int Microseconds)
+{
+   if (mEpoll < 0)
+      return false;
+
+   mBusyPoll = (Microseconds > 0) ? Microseconds : 0;
+
+#ifdef EPIOCSPARAMS
+   // the kernel polls the NAPI queues of the sockets on this epoll inside
+   // epoll_wait(), nothing left for RunOnce() to do
+   struct epoll_params params = {};
+
+   params.busy_poll_usecs  = mBusyPoll;
+   params.busy_poll_budget = MAX_EVENTS_PER_WAIT;
+   params.prefer_busy_poll = (mBusyPoll > 0);
+
+   if (ioctl(mEpoll, EPIOCSPARAMS, &params) == 0)
+      mBusyPoll = 0;
+#endif
+
+   return true;
+}
+
+int CEventLoop::Wait(struct epoll_event* Events, int TimeoutMs)
+{
+   int count = 0;
+
+   if (mBusyPoll > 0 && TimeoutMs != 0)
+   {
+      CStopwatch spin;
+      double     budget = mBusyPoll * 1.0e-6;
+
+      spin.Start();
+
+      do
+      {
+         count = epoll_wait(mEpoll, Events, MAX_EVENTS_PER_WAIT, 0);
+      } while (count == 0 && spin.GetTime() < budget);
+
+      if (count != 0)
+         return count;
+   }
+
+   return epoll_wait(mEpoll, Events, MAX_EVENTS_PER_WAIT, TimeoutMs);
+}
+
+int CEventLoop::RunOnce(int TimeoutMs)
+{
+   struct epoll_event events[MAX_EVENTS_PER_WAIT];
+   int                count;
+   int                handled = 0;
+
+   count = Wait(events, TimeoutMs);
+
+   if (count < 0)
+   {
+      if (errno == EINTR)
+         return 0;
+
+      perror("EventLoop: epoll_wait()");
+      return -1;
+   }
+
+   for (int i = 0; i < count; i++)
+   {
+      uint32_t index = events[i].data.u32;
+      uint64_t value;
+
+      if (index == WAKEUP_SOURCE)
+      {
+         // just clears the counter, the wakeup only had to end the wait
+         if (read(mWakeup, &value, sizeof(value)) < 0) {}
+         continue;
+      }
+
+      TSource& source = mSources[index];
+
+      // removed by a handler earlier in this batch
+      if (source.Fd < 0)
+         continue;
+
+      // a timer re-armed by an earlier handler has nothing to read
+      if (source.Timer && read(source.Fd, &value, sizeof(value)) != sizeof(value))
+         continue;
+
+      source.Handler(source.Context);
+      handled++;
+   }
+
+   return handled;
+}
+
+void CEventLoop::Run()
+{
+   while (!mStopped)
+   {
+      if (RunOnce(-1) < 0)
+         break;
+   }
+}
+
+void CEventLoop::Stop()
+{
+   mStopped = true;
+   Wakeup();
+}
+
+void CEventLoop::Wakeup()
+{
+   uint64_t value = 1;
+
+   if (mWakeup >= 0 && write(mWakeup, &value, sizeof(value)) < 0) {}
+}
@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS § 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  © Veraxx Engineering Corporation 2021.  All rights reserved.
+//
+// DEVELOPED BY:
+//  Veraxx Engineering Corporation
+//  14130 Sullyfield Circle, Suite B
+//  Chantilly, VA 20151
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//  Title:      Event Loop
+//  Class:      C++ Header
+//  Filename:   EventLoop.h
+//  Author:     Brian Woodard
+//  Purpose:    This module performs the following tasks:
+//
+//  Provides an epoll based event loop that waits on sockets, timers and a
+//  wakeup event, so a thread only runs when there is work to do.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include "SimUdpSocket.h"
+
+const int MAX_EVENT_SOURCES   = 16;   // sockets plus timers on one loop
+const int MAX_EVENTS_PER_WAIT = 16;
+
+// Linux only (epoll, timerfd, eventfd). Handlers run on the thread calling
+// Run()/RunOnce(), everything else except Stop() and Wakeup() must be called
+// from that thread too (or before it starts).
+class CEventLoop
+{
+public:
+
+   typedef void (*THandler)(void* Context);
+
+   CEventLoop();
+   ~CEventLoop();
+
+   //! \fn bool Open()
+   //! \details Creates the epoll instance and the wakeup event.
+   bool Open();
+
+   //! \fn void Close()
+   //! \details Closes every timer and the loop itself, sockets stay open.
+   void Close();
+
+   //! \fn int AddSocket(CSimUdpSocket& Socket, THandler Handler, void* Context)
+   //! \details Switches Socket to non-blocking and runs Handler whenever it is
+   //!          readable. The handler should read until the socket is empty
+   //!          (or disable it), it keeps firing while data is waiting.
+   //!          Returns the source id or -1.
+   int  AddSocket(CSimUdpSocket& Socket, THandler Handler, void* Context);
+
+   //! \fn int AddTimer(THandler Handler, void* Context)
+   //! \details Creates a timer that runs Handler when it expires, the timer
+   //!          is idle until StartTimer(). Returns the source id or -1.
+   int  AddTimer(THandler Handler, void* Context);
+
+   //! \fn bool StartTimer(int Id, double Seconds, bool Repeat)
+   //! \details Arms (or re-arms, restarting the countdown) a timer.
+   bool StartTimer(int Id, double Seconds, bool Repeat = false);
+
+   //! \fn bool StopTimer(int Id)
+   //! \details Disarms a timer without removing it.
+   bool StopTimer(int Id);
+
+   //! \fn bool EnableSocket(int Id, bool Enable)
+   //! \details Stops or resumes watching a socket, e.g. while there is
+   //!          nowhere to put what it would read.
+   bool EnableSocket(int Id, bool Enable);
+
+   //! \fn void Remove(int Id)
+   //! \details Removes a source, timers are closed, sockets are not.
+   void Remove(int Id);
+
+   //! \fn bool SetBusyPoll(int Microseconds)
+   //! \details Low-latency mode, call after Open(). Each wait first polls
+   //!          for up to Microseconds before sleeping, so data that arrives
+   //!          in that window is handled without a wakeup. The kernel does
+   //!          the polling (EPIOCSPARAMS, Linux 6.9+) when it can, otherwise
+   //!          RunOnce() spins on a zero timeout epoll_wait(). Costs CPU, 0
+   //!          turns it off.
+   bool SetBusyPoll(int Microseconds);
+
+   //! \fn int RunOnce(int TimeoutMs)
+   //! \details Waits up to TimeoutMs (-1 forever, plus any busy poll time)
+   //!          for events and runs their handlers. Returns the handlers run
+   //!          or -1 on error.
+   int  RunOnce(int TimeoutMs = -1);
+
+   //! \fn void Run()
+   //! \details Runs handlers until Stop(), a Stop() made before Run() starts
+   //!          still counts.
+   void Run();
+
+   //! \fn void Stop()
+   //! \details Makes Run() return, safe from any thread.
+   void Stop();
+
+   //! \fn void Wakeup()
+   //! \details Makes a waiting RunOnce() return, safe from any thread.
+   void Wakeup();
+
+private:
+
+   struct TSource
+   {
+      int            Fd;        // -1 if unused
+      bool           Timer;     // timerfd owned by the loop
+      CSimUdpSocket* Socket;
+      THandler       Handler;
+      void*          Context;
+   };
+
+   int  AddSource(int Fd, bool Timer, CSimUdpSocket* Socket, THandler Handler, void* Context);
+   bool ValidSource(int Id, bool Timer);
+   int  Wait(struct epoll_event* Events, int TimeoutMs);
+
+   int               mEpoll;
+   int               mWakeup;
+   int               mBusyPoll;     // microseconds RunOnce() spins, 0 if off
+   std::atomic<bool> mStopped;
+   TSource           mSources[MAX_EVENT_SOURCES];
+
+};
@@ -65,6 +65,9 @@ CSimUdpSocket::CSimUdpSocket()
 
    // initialize
    mIsOpen = false;
+   mDestinationCount = 0;
+   mSendCount = 0;
+   mSendUsed = 0;
 }
 
 
@@ -73,6 +76,9 @@ CSimUdpSocket::CSimUdpSocket(char *IpAddress, int SendPort, int RecvPort)
 
    // initialize
    mIsOpen = false;
+   mDestinationCount = 0;
+   mSendCount = 0;
+   mSendUsed = 0;
 
    // open the socket
    mIsOpen = Open(IpAddress, SendPort, RecvPort);
@@ -204,6 +210,188 @@ int  CSimUdpSocket::ReceiveFromSocket(char *DataBuffer, int MaxSizeToRead)
   return(bytes_returned);
 }
 
+int CSimUdpSocket::ReceiveBatch(TDatagram *Datagrams, int Count)
+{
+   if (Count > MAX_RECEIVE_BATCH)
+      Count = MAX_RECEIVE_BATCH;
+
+   if (Count <= 0)
+      return 0;
+
+#ifdef WIN32
+   // no recvmmsg, read whatever is already queued one datagram at a time
+   int received = 0;
+
+   while (received < Count)
+   {
+      TDatagram&    datagram = Datagrams[received];
+      int           fromlen = sizeof(datagram.Source);
+      unsigned long waiting = 0;
+
+      // only the first read may block
+      if (received > 0 && (ioctlsocket(mSocket, FIONREAD, &waiting) != 0 || waiting == 0))
+         break;
+
+      datagram.Length = recvfrom(mSocket, datagram.Buffer, datagram.Capacity, 0, (struct sockaddr*)&datagram.Source, &fromlen);
+
+      if (datagram.Length == SOCKET_ERROR)
+      {
+         // the rest of a datagram that didn't fit has been discarded
+         if (WSAGetLastError() == WSAEMSGSIZE)
+         {
+            datagram.Length = -1;
+            received++;
+            continue;
+         }
+
+         if (received > 0)
+            break;
+
+         return (WSAGetLastError() == WSAEWOULDBLOCK) ? -3 : -1;
+      }
+
+      received++;
+   }
+
+   return received;
+#else
+   int received;
+
+   for (int i = 0; i < Count; i++)
+   {
+      mReceiveIovecs[i].iov_base = Datagrams[i].Buffer;
+      mReceiveIovecs[i].iov_len  = Datagrams[i].Capacity;
+
+      memset(&mReceiveMsgs[i], 0, sizeof(mReceiveMsgs[i]));
+      mReceiveMsgs[i].msg_hdr.msg_iov     = &mReceiveIovecs[i];
+      mReceiveMsgs[i].msg_hdr.msg_iovlen  = 1;
+      mReceiveMsgs[i].msg_hdr.msg_name    = &Datagrams[i].Source;
+      mReceiveMsgs[i].msg_hdr.msg_namelen = sizeof(Datagrams[i].Source);
+   }
+
+   // MSG_WAITFORONE, a blocking socket only waits for the first datagram
+   received = recvmmsg(mSocket, mReceiveMsgs, Count, MSG_WAITFORONE, nullptr);
+
+   if (received == -1)
+   {
+      if (errno == EAGAIN)
+         return -3;
+      else
+         return -1;
+   }
+
+   // msg_len is clipped to the buffer, a truncated datagram is useless
+   for (int i = 0; i < received; i++)
+      Datagrams[i].Length = (mReceiveMsgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : (int)mReceiveMsgs[i].msg_len;
+
+   return received;
+#endif
+}
+
+bool CSimUdpSocket::AddDestination(char *IpAddress, int Port)
+{
+   if (mDestinationCount >= MAX_SEND_DESTINATIONS - 1)
+      return false;
+
+   struct sockaddr_in& address = mDestinations[mDestinationCount];
+
+   memset (&address, 0, sizeof(address));
+   address.sin_addr.s_addr = inet_addr(IpAddress);
+   address.sin_family      = AF_INET;
+   address.sin_port        = htons(Port);
+
+   mDestinationCount++;
+
+   return true;
+}
+
+bool CSimUdpSocket::QueueSend(const char *DataBuffer, int SizeInBytes)
+{
+   if (SizeInBytes <= 0 || SizeInBytes > MAX_SEND_BYTES)
+      return false;
+
+   // make room by sending what is already queued
+   if (mSendCount == MAX_SEND_BATCH || mSendUsed + SizeInBytes > MAX_SEND_BYTES)
+      FlushSends();
+
+   memcpy(&mSendData[mSendUsed], DataBuffer, SizeInBytes);
+   mSendOffsets[mSendCount] = mSendUsed;
+   mSendSizes[mSendCount]   = SizeInBytes;
+
+   mSendUsed += SizeInBytes;
+   mSendCount++;
+
+   return true;
+}
+
+int CSimUdpSocket::FlushSends()
+{
+   int total = mSendCount * (1 + mDestinationCount);
+   int sent = 0;
+   int status = 0;
+
+   // message i is datagram i % mSendCount to destination i / mSendCount
+   // (0 is the primary), sent in chunks of MAX_SEND_BATCH
+   while (sent < total)
+   {
+      int count = total - sent;
+
+      if (count > MAX_SEND_BATCH)
+         count = MAX_SEND_BATCH;
+
+#ifdef WIN32
+      for (int i = 0; i < count; i++)
+      {
+         int                 datagram = (sent + i) % mSendCount;
+         int                 destination = (sent + i) / mSendCount;
+         struct sockaddr_in* address = (destination == 0) ? &mAddressOut : &mDestinations[destination - 1];
+
+         if (sendto(mSocket, &mSendData[mSendOffsets[datagram]], mSendSizes[datagram], 0, (struct sockaddr*)address, sizeof(*address)) < 0)
+         {
+            status = -1;
+            break;
+         }
+      }
+
+      if (status < 0)
+         break;
+#else
+      for (int i = 0; i < count; i++)
+      {
+         int                 datagram = (sent + i) % mSendCount;
+         int                 destination = (sent + i) / mSendCount;
+         struct sockaddr_in* address = (destination == 0) ? &mAddressOut : &mDestinations[destination - 1];
+
+         mSendIovecs[i].iov_base = &mSendData[mSendOffsets[datagram]];
+         mSendIovecs[i].iov_len  = mSendSizes[datagram];
+
+         memset(&mSendMsgs[i], 0, sizeof(mSendMsgs[i]));
+         mSendMsgs[i].msg_hdr.msg_iov     = &mSendIovecs[i];
+         mSendMsgs[i].msg_hdr.msg_iovlen  = 1;
+         mSendMsgs[i].msg_hdr.msg_name    = address;
+         mSendMsgs[i].msg_hdr.msg_namelen = sizeof(*address);
+      }
+
+      // sendmmsg may stop early, the rest goes out on the next pass
+      count = sendmmsg(mSocket, mSendMsgs, count, 0);
+
+      if (count <= 0)
+      {
+         status = -1;
+         break;
+      }
+#endif
+
+      sent += count;
+   }
+
+   // a failed flush drops the queue rather than resending stale input
+   mSendCount = 0;
+   mSendUsed = 0;
+
+   return (status < 0) ? -1 : sent;
+}
+
 void CSimUdpSocket::SetNonBlockingFlag()
 {
 #ifdef WIN32
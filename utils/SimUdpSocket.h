@@ -67,10 +67,27 @@
 #endif
 #endif
 
+// most datagrams one ReceiveBatch() call will return
+const int MAX_RECEIVE_BATCH = 64;
+
+// limits of the queued send path, a full queue is flushed automatically
+const int MAX_SEND_BATCH        = 64;          // datagrams per sendmmsg
+const int MAX_SEND_BYTES        = 64 * 1024;   // queued payload
+const int MAX_SEND_DESTINATIONS = 4;           // primary plus extra destinations
+
                                                                                                                             
 class CSimUdpSocket
 {
 public:
+
+   // one datagram for ReceiveBatch(), the caller sets Buffer and Capacity
+   struct TDatagram
+   {
+      char*              Buffer;
+      int                Capacity;
+      int                Length;   // bytes received, -1 if it didn't fit in Capacity
+      struct sockaddr_in Source;
+   };
                                                                                                                             
    CSimUdpSocket();
    CSimUdpSocket(char* IpAddr, int SendPort, int ReceivePort);
@@ -81,9 +98,32 @@ public:
    int  SendToSocket(char* DataBuffer, int SizeInBytes);
    int  ReceiveFromSocket(char* DataBuffer, int MaxSizeToRead);
 
+   // drains up to Count datagrams (at most MAX_RECEIVE_BATCH) with one
+   // recvmmsg, only the first waits on a blocking socket, returns the number
+   // received, -3 if nothing was waiting on a non-blocking socket, -1 on error,
+   // a truncated datagram is still counted but its Length is -1
+   int  ReceiveBatch(TDatagram* Datagrams, int Count);
+
+   // every queued datagram is also sent here (e.g. a recorder), the primary
+   // destination is always the address given to Open()
+   bool AddDestination(char* IpAddr, int Port);
+
+   // copies the datagram into the send queue, nothing is sent until
+   // FlushSends() unless the queue fills up
+   bool QueueSend(const char* DataBuffer, int SizeInBytes);
+
+   // sends everything queued to every destination with as few sendmmsg
+   // calls as possible, returns the datagrams sent or -1 on error
+   int  FlushSends();
+
    void SetNonBlockingFlag();
    void ClearNonBlockingFlag();
 
+#ifndef WIN32
+   // for waiting on the socket with select/epoll
+   int  GetDescriptor() { return mSocket; }
+#endif
+
 private:
 
    bool   mIsOpen;
@@ -95,5 +135,19 @@ private:
 
    struct sockaddr_in mAddressOut;
    struct sockaddr_in mAddressIn;
+#ifndef WIN32
+   struct mmsghdr     mReceiveMsgs[MAX_RECEIVE_BATCH];
+   struct iovec       mReceiveIovecs[MAX_RECEIVE_BATCH];
+   struct mmsghdr     mSendMsgs[MAX_SEND_BATCH];
+   struct iovec       mSendIovecs[MAX_SEND_BATCH];
+#endif
+
+   struct sockaddr_in mDestinations[MAX_SEND_DESTINATIONS - 1];
+   int                mDestinationCount;
+   char               mSendData[MAX_SEND_BYTES];
+   int                mSendOffsets[MAX_SEND_BATCH];
+   int                mSendSizes[MAX_SEND_BATCH];
+   int                mSendCount;
+   int                mSendUsed;
 };
                                                                                                                           
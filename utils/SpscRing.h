@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS § 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  © Veraxx Engineering Corporation 2021.  All rights reserved.
+//
+// DEVELOPED BY:
+//  Veraxx Engineering Corporation
+//  14130 Sullyfield Circle, Suite B
+//  Chantilly, VA 20151
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//  Title:      Single Producer/Single Consumer Ring
+//  Class:      C++ Header
+//  Filename:   SpscRing.h
+//  Author:     Brian Woodard
+//  Purpose:    This module performs the following tasks:
+//
+//  Provides a bounded lock-free ring of preallocated slots for handing data
+//  from one producer thread to one consumer thread.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+// Slots are filled and read in place, so large items (e.g. PDU buffers) are
+// never copied through the ring. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class CSpscRing
+{
+   static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+
+   CSpscRing() : mHead(0), mTail(0), mHeadCache(0) {}
+
+   //! \fn size_t WriteAvailable()
+   //! \details Producer only. Returns how many slots can be written before
+   //!          the ring is full.
+   size_t WriteAvailable()
+   {
+      return Capacity - (mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_acquire));
+   }
+
+   //! \fn T& WriteSlot(size_t Index)
+   //! \details Producer only. Returns the slot Index past the write position,
+   //!          Index must be less than WriteAvailable().
+   T& WriteSlot(size_t Index = 0)
+   {
+      return mSlots[(mHead.load(std::memory_order_relaxed) + Index) & (Capacity - 1)];
+   }
+
+   //! \fn void Commit(size_t Count)
+   //! \details Producer only. Publishes the next Count written slots.
+   void Commit(size_t Count = 1)
+   {
+      mHead.store(mHead.load(std::memory_order_relaxed) + Count, std::memory_order_release);
+   }
+
+   //! \fn T* Front()
+   //! \details Consumer only. Returns the oldest published slot, or nullptr
+   //!          if the ring is empty. The slot stays valid until Pop().
+   T* Front()
+   {
+      size_t tail = mTail.load(std::memory_order_relaxed);
+
+      if (tail == mHeadCache)
+      {
+         mHeadCache = mHead.load(std::memory_order_acquire);
+
+         if (tail == mHeadCache)
+            return nullptr;
+      }
+
+      return &mSlots[tail & (Capacity - 1)];
+   }
+
+   //! \fn void Pop()
+   //! \details Consumer only. Hands the slot from Front() back to the producer.
+   void Pop()
+   {
+      mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+   }
+
+private:
+
+   // producer and consumer indices on their own cache lines, the consumer
+   // keeps a copy of the head so draining only touches the producer's line
+   // when the ring looks empty, the producer reads the tail once per batch
+   alignas(64) std::atomic<size_t> mHead;
+   alignas(64) std::atomic<size_t> mTail;
+   size_t                          mHeadCache;
+   alignas(64) T                   mSlots[Capacity];
+
+};
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+//                            UNCLASSIFIED
+//-----------------------------------------------------------------------------
+//                    DO NOT REMOVE OR MODIFY THIS HEADER
+//-----------------------------------------------------------------------------
+//
+//  This software and the accompanying documentation are provided to the U.S.
+//  Government with unlimited rights as provided in DFARS § 252.227-7014.  The
+//  contractor, Veraxx Engineering Corporation, retains ownership, the
+//  copyrights, and all other rights.
+//
+//  © Veraxx Engineering Corporation 2021.  All rights reserved.
+//
+// DEVELOPED BY:
+//  Veraxx Engineering Corporation
+//  14130 Sullyfield Circle, Suite B
+//  Chantilly, VA 20151
+//  (703)880-9000 (Voice)
+//  (703)880-9005 (Fax)
+//-----------------------------------------------------------------------------
+//  Title:      Triple Buffer
+//  Class:      C++ Header
+//  Filename:   TripleBuffer.h
+//  Author:     Brian Woodard
+//  Purpose:    This module performs the following tasks:
+//
+//  Provides a lock-free latest-value exchange between one writer thread and
+//  one reader thread.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+
+// The writer fills its private buffer and publishes it by swapping it with
+// the shared middle buffer, the reader picks up the newest published buffer
+// by swapping its own with the middle one. Neither side ever waits and the
+// reader never sees a partially written value, intermediate values the
+// reader didn't get to are simply overwritten.
+template <typename T>
+class CTripleBuffer
+{
+public:
+
+   CTripleBuffer() : mBuffers{}, mWrite(0), mMiddle(1), mRead(2) {}
+
+   //! \fn T& WriteBuffer()
+   //! \details Writer only. The buffer to fill before calling Publish(), its
+   //!          contents are whatever was published two swaps ago.
+   T& WriteBuffer() { return mBuffers[mWrite]; }
+
+   //! \fn void Publish()
+   //! \details Writer only. Makes the write buffer the newest value.
+   void Publish()
+   {
+      mWrite = mMiddle.exchange(mWrite | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+   }
+
+   //! \fn void Write(const T& Value)
+   //! \details Writer only. Copies Value into the write buffer and publishes it.
+   void Write(const T& Value)
+   {
+      mBuffers[mWrite] = Value;
+      Publish();
+   }
+
+   //! \fn bool Update()
+   //! \details Reader only. Swaps in the newest published value, returns
+   //!          false and keeps the current one if nothing was published
+   //!          since the last call.
+   bool Update()
+   {
+      if (!(mMiddle.load(std::memory_order_relaxed) & FRESH))
+         return false;
+
+      mRead = mMiddle.exchange(mRead, std::memory_order_acq_rel) & INDEX_MASK;
+
+      return true;
+   }
+
+   //! \fn T& Read()
+   //! \details Reader only. The value picked up by the last Update(), stays
+   //!          untouched by the writer until the next Update().
+   T& Read() { return mBuffers[mRead]; }
+
+private:
+
+   static const unsigned INDEX_MASK = 3;
+   static const unsigned FRESH      = 4;   // middle buffer not yet seen by the reader
+
+   T                                 mBuffers[3];
+   alignas(64) unsigned              mWrite;
+   alignas(64) std::atomic<unsigned> mMiddle;
+   alignas(64) unsigned              mRead;
+
+};